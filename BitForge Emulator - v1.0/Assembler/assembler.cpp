@@ -1,8 +1,14 @@
 #include "assembler.h"
+#include "../Linker/linker.h"
 #include <fstream>
 #include <iostream>
 #include <cctype>
 #include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <algorithm>
+#include <charconv>
+#include <bit>
 
 Assembler assembler;
 
@@ -13,8 +19,8 @@ std::string Assembler::trim(const std::string& s) {
     return s.substr(a, b - a);
 }
 
-std::vector<std::string> Assembler::split(const std::string& s) {
-    std::vector<std::string> out;
+void Assembler::split(std::string_view s, std::vector<std::string_view>& out) {
+    out.clear();
     size_t i = 0;
     while (i < s.size()) {
         while (i < s.size() && std::isspace(s[i])) ++i;
@@ -27,51 +33,66 @@ std::vector<std::string> Assembler::split(const std::string& s) {
         } else {
             size_t start = i;
             while (i < s.size() && !std::isspace(s[i])) ++i;
-            std::string token = s.substr(start, i - start);
-            if (token.find('<') != std::string::npos) {
-                auto parts = parseDescriptor(token);
-                for (const auto& p : parts) out.push_back(p);
-            } else {
+            std::string_view token = s.substr(start, i - start);
+            if (token.find('<') == std::string_view::npos) {
                 out.push_back(token);
+                continue;
+            }
+
+            // r8<i64< -> r8, i64. An empty part repeats the previous type.
+            std::string_view last;
+            size_t partStart = 0;
+            for (size_t p = 0; p < token.size(); p++) {
+                if (token[p] != '<') continue;
+                std::string_view part = token.substr(partStart, p - partStart);
+                if (part.empty()) part = last;
+                else last = part;
+                out.push_back(part);
+                partStart = p + 1;
             }
         }
     }
-    return out;
 }
 
-std::vector<std::string> Assembler::parseDescriptor(const std::string& desc) {
-    std::vector<std::string> parts;
-    std::string current;
-    for (char c : desc) {
-        if (c == '<') {
-            parts.push_back(current);
-            current = "";
-        } else {
-            current += c;
-        }
-    }
+std::string Assembler::resolveInclude(const std::string& name, const std::string& fromFile) {
+    namespace fs = std::filesystem;
 
-    std::vector<std::string> result;
-    std::string last;
-    for (const auto& part : parts) {
-        if (part.empty()) {
-            result.push_back(last);
-        } else {
-            result.push_back(part);
-            last = part;
-        }
+    fs::path local = fs::path(fromFile).parent_path() / name;
+    if (fs::exists(local)) return local.string();
+
+    for (const auto& dir : includePaths) {
+        fs::path candidate = fs::path(dir) / name;
+        if (fs::exists(candidate)) return candidate.string();
     }
-    return result;
+
+    return name;
 }
 
-std::vector<std::string> Assembler::readFile(const std::string& filename) {
+// Streams the cleaned (comment free, trimmed, non empty) lines of a file to handle.
+// .include "file" lines are replaced by the lines of that file, .macro bodies are recorded
+// and everything else goes through preprocessLine.
+void Assembler::readFile(const std::string& filename, const std::function<void(const std::string&)>& handle, int depth) {
+    if (depth > 32) error("ASM00005", "Include nesting too deep: " + filename);
+
+    const std::string* file = &*sourceFiles.insert(filename).first;
+    size_t lineNumber = 0;
+
+    if (depth == 0) {
+        defines.clear();
+        macros.clear();
+        recording = nullptr;
+        macroExpansions = 0;
+    }
+
     std::ifstream f(filename);
-    if (!f) throw std::runtime_error("Cannot open: " + filename);
-    std::vector<std::string> lines;
+    if (!f) error("ASM00004", filename);
+
     std::string line;
+    std::string result;
     bool inBlock = false;
     while (std::getline(f, line)) {
-        std::string result;
+        lineNumber++;
+        result.clear();
         bool inStr = false;
         for (size_t i = 0; i < line.size(); ++i) {
             if (line[i] == '"' && !inBlock) { inStr = !inStr; result += line[i]; continue; }
@@ -82,59 +103,284 @@ std::vector<std::string> Assembler::readFile(const std::string& filename) {
             result += line[i];
         }
         result = trim(result);
-        if (!result.empty()) lines.push_back(result);
+        if (result.empty()) continue;
+
+        if (recording) {
+            if (result.rfind(".endm", 0) == 0) recording = nullptr;
+            else if (result.rfind(".macro", 0) == 0) error("ASM00010", "Nested .macro: " + result);
+            else recording->body.push_back(result);
+            continue;
+        }
+
+        if (result.rfind(".include", 0) == 0) {
+            size_t open = result.find('"');
+            size_t close = result.rfind('"');
+            if (open == std::string::npos || close <= open) error("ASM00005", filename + ": " + result);
+            readFile(resolveInclude(result.substr(open + 1, close - open - 1), filename), handle, depth + 1);
+            continue;
+        }
+
+        location = {file, lineNumber};
+        preprocessLine(result, handle, depth);
+    }
+
+    if (depth == 0 && recording) error("ASM00010", "Missing .endm in " + filename);
+}
+
+// Whitespace separated words of a line, a quoted string stays one word with its quotes.
+static std::vector<std::string> splitWords(const std::string& line) {
+    std::vector<std::string> words;
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && std::isspace(static_cast<unsigned char>(line[i]))) ++i;
+        if (i >= line.size()) break;
+
+        size_t start = i;
+        bool inStr = false;
+        while (i < line.size() && (inStr || !std::isspace(static_cast<unsigned char>(line[i])))) {
+            if (line[i] == '"') inStr = !inStr;
+            ++i;
+        }
+        words.push_back(line.substr(start, i - start));
+    }
+    return words;
+}
+
+// Rebuilds line with every word that names an entry of lookup replaced by its text.
+template <typename Lookup>
+static std::string substituteWords(const std::vector<std::string>& words, size_t first, Lookup lookup) {
+    std::string text;
+    for (size_t i = first; i < words.size(); i++) {
+        if (!text.empty()) text += ' ';
+        const std::string* replacement = words[i][0] == '"' ? nullptr : lookup(words[i]);
+        text += replacement ? *replacement : words[i];
+    }
+    return text;
+}
+
+// Handles .equ, .define, .macro and macro calls, substitutes constants into every other line
+// and passes it on.
+void Assembler::preprocessLine(const std::string& line, const std::function<void(const std::string&)>& handle, int depth) {
+    if (depth > 64) error("ASM00010", "Macro expansion too deep: " + line);
+
+    std::vector<std::string> words = splitWords(line);
+    auto lookupDefine = [&](const std::string& word) -> const std::string* {
+        auto it = defines.find(word);
+        return it == defines.end() ? nullptr : &it->second;
+    };
+
+    if (words[0] == ".equ" || words[0] == ".define") {
+        if (words.size() < 3) error("ASM00010", "Missing value: " + line);
+
+        std::string value = substituteWords(words, 2, lookupDefine);
+        if (words[0] == ".equ") value = std::to_string(parseNumber(value));
+        if (!defines.emplace(words[1], value).second) error("ASM00010", "Constant defined more than once: " + words[1]);
+        return;
+    }
+
+    if (words[0] == ".macro") {
+        if (words.size() < 2 || findMnemonic(words[1])) error("ASM00010", "Invalid macro name: " + line);
+
+        auto [it, added] = macros.emplace(words[1], Macro{});
+        if (!added) error("ASM00010", "Macro defined more than once: " + words[1]);
+        it->second.parameters.assign(words.begin() + 2, words.end());
+        recording = &it->second;
+        return;
+    }
+
+    if (words[0] == ".endm") error("ASM00010", ".endm without .macro");
+
+    auto macro = macros.find(words[0]);
+    if (macro == macros.end()) {
+        handle(substituteWords(words, 0, lookupDefine));
+        return;
+    }
+
+    const Macro& m = macro->second;
+    if (words.size() - 1 != m.parameters.size())
+        error("ASM00010", "Macro " + words[0] + " takes " + std::to_string(m.parameters.size()) + " arguments: " + line);
+
+    // \@ in a macro body becomes a number unique to this expansion, for local labels.
+    std::string unique = std::to_string(macroExpansions++);
+    auto lookupArgument = [&](const std::string& word) -> const std::string* {
+        for (size_t p = 0; p < m.parameters.size(); p++)
+            if (m.parameters[p] == word) return &words[p + 1];
+        return nullptr;
+    };
+
+    for (const auto& bodyLine : m.body) {
+        std::string expanded = substituteWords(splitWords(bodyLine), 0, lookupArgument);
+        for (size_t at = expanded.find("\\@"); at != std::string::npos; at = expanded.find("\\@", at))
+            expanded.replace(at, 2, unique);
+        preprocessLine(expanded, handle, depth + 1);
     }
-    return lines;
 }
 
 void Assembler::error(const std::string& type, const std::string& info) const {
-    std::cout << "ERROR [" << type << "]";
-    if (!info.empty()) std::cout << " - " << info;
-    std::cout << "\nStopping...\n";
-    exit(0);
-}
-
-uint8_t Assembler::descriptorByte(const std::string& type) {
-    if (type == "r8")  return 0x00;
-    if (type == "i8")  return 0x01;
-    if (type == "i16") return 0x02;
-    if (type == "i32") return 0x03;
-    if (type == "i64") return 0x04;
-    if (type == "mi8")  return 0x05;
-    if (type == "mi16") return 0x06;
-    if (type == "mi32") return 0x07;
-    if (type == "mi64") return 0x08;
-    if (type == "mr8")  return 0x09;
-    if (type == "i")    return 0x0A;
-    if (type == "lbl") return 0x04;
-    if (type == "str")    return 0x0A;
-    error("ASM00005", "Unknown operand type: " + type);
-    return 0;
+    std::cerr << "ERROR [" << type << "]";
+    if (!info.empty()) std::cerr << " - " << info;
+    std::cerr << "\nStopping...\n";
+    exit(1);
 }
 
-int Assembler::operandSize(const std::string& type) {
-    if (type == "r8" || type == "i8" || type == "mi8" || type == "mr8") return 1;
-    if (type == "i16" || type == "mi16") return 2;
-    if (type == "i32" || type == "mi32") return 4;
-    if (type == "i64" || type == "mi64") return 8;
-    if (type == "i") return 0;
-    if (type == "lbl") return 8;
-    if (type == "str") return 0;
-    error("ASM00005", "Unknown operand size: " + type);
+static int widthBytes(std::string_view digits) {
+    switch (digits.size()) {
+        case 1: return digits[0] == '8' ? 1 : 0;
+        case 2:
+            if (digits == "16") return 2;
+            if (digits == "32") return 4;
+            if (digits == "64") return 8;
+            return 0;
+    }
     return 0;
 }
 
-void Assembler::encodeOperand(const std::string& type, const std::string& valueToken) {
-    int size = operandSize(type);
-    uint64_t value = std::stoull(valueToken, nullptr, 0);
+// Descriptor byte and operand size of an operand type such as r8, i64, mi16, lbl or str.
+static bool descriptorInfo(std::string_view type, uint8_t& byte, int& size) {
+    if (type.empty()) return false;
+
+    switch (type[0]) {
+        case 'r':
+            if (type != "r8") return false;
+            byte = 0x00; size = 1;
+            return true;
+
+        case 'i':
+            if (type.size() == 1) { byte = 0x0A; size = 0; return true; }
+            size = widthBytes(type.substr(1));
+            if (size == 0) return false;
+            byte = 0x01 + std::countr_zero(static_cast<unsigned>(size));
+            return true;
+
+        case 'm':
+            if (type == "mr8") { byte = 0x09; size = 1; return true; }
+            if (type.size() < 3 || type[1] != 'i') return false;
+            size = widthBytes(type.substr(2));
+            if (size == 0) return false;
+            byte = 0x05 + std::countr_zero(static_cast<unsigned>(size));
+            return true;
+
+        case 'l':
+            if (type != "lbl") return false;
+            byte = 0x04; size = 8;
+            return true;
+
+        case 's':
+            if (type != "str") return false;
+            byte = 0x0A; size = 0;
+            return true;
+    }
+
+    return false;
+}
+
+uint8_t Assembler::descriptorByte(std::string_view type) {
+    uint8_t byte; int size;
+    if (!descriptorInfo(type, byte, size)) error("ASM00005", "Unknown operand type: " + std::string(type));
+    return byte;
+}
+
+int Assembler::operandSize(std::string_view type) {
+    uint8_t byte; int size;
+    if (!descriptorInfo(type, byte, size)) error("ASM00005", "Unknown operand size: " + std::string(type));
+    return size;
+}
+
+uint64_t Assembler::parseNumber(std::string_view token) {
+    std::string_view digits = token;
+    bool negative = !digits.empty() && digits[0] == '-';
+    if (negative || (!digits.empty() && digits[0] == '+')) digits.remove_prefix(1);
+
+    int base = 10;
+    if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        base = 16;
+        digits.remove_prefix(2);
+    } else if (digits.size() > 1 && digits[0] == '0') {
+        base = 8;
+        digits.remove_prefix(1);
+    }
+
+    uint64_t value = 0;
+    auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value, base);
+    if (digits.empty() || ec != std::errc() || end != digits.data() + digits.size())
+        error("ASM00005", "Invalid number: " + std::string(token));
+
+    return negative ? ~value + 1 : value;
+}
+
+uint64_t Assembler::operandValue(std::string_view valueToken) {
+    if (!valueToken.empty() && valueToken[0] == '!') {
+        auto it = labels.find(valueToken.substr(1));
+        if (it == labels.end()) error("ASM00008", "Undefined label: " + std::string(valueToken));
+        return it->second;
+    }
+
+    return parseNumber(valueToken);
+}
+
+void Assembler::encodeOperand(std::string_view type, std::string_view valueToken, uint8_t*& out) {
+    encodeValue(valueToken, operandSize(type), out);
+}
+
+void Assembler::encodeValue(std::string_view valueToken, int size, uint8_t*& out) {
+    uint64_t value;
+
+    // Objects are linked at an unknown address, every label is left to the linker.
+    if (objectMode && !valueToken.empty() && valueToken[0] == '!') {
+        labelReferences.push_back({static_cast<uint64_t>(out - output.data()), static_cast<uint8_t>(size), std::string(valueToken.substr(1))});
+        value = 0;
+    } else {
+        value = operandValue(valueToken);
+    }
+
     for (int i = 0; i < size; i++) {
-        output.push_back((value >> (i * 8)) & 0xFF);
+        *out++ = (value >> (i * 8)) & 0xFF;
+    }
+}
+
+static int narrowestWidth(uint64_t value) {
+    if (value <= 0xFF) return 1;
+    if (value <= 0xFFFF) return 2;
+    if (value <= 0xFFFFFFFF) return 4;
+    return 8;
+}
+
+static bool narrowable(std::string_view type) {
+    return type == "i16" || type == "i32" || type == "i64" || type == "lbl" ||
+           type == "mi16" || type == "mi32" || type == "mi64";
+}
+
+// Descriptor byte for a narrowable type shrunk to size bytes.
+static uint8_t narrowedDescriptor(std::string_view type, int size) {
+    return (type[0] == 'm' ? 0x05 : 0x01) + std::countr_zero(static_cast<unsigned>(size));
+}
+
+// Bytes an operand takes in the image. With --optimize-size immediates and addresses get
+// the narrowest width that holds their value; the CPU zero extends them, so only values
+// that fit unsigned are narrowed. Label widths start at one byte and only ever grow while
+// firstPass iterates, using the addresses of the previous iteration.
+int Assembler::encodedSize(std::string_view type, std::string_view valueToken) {
+    int declared = operandSize(type);
+    if (!optimizeSize || !narrowable(type)) return declared;
+
+    if (valueToken[0] == '!') {
+        if (objectMode) return declared;
+
+        size_t index = labelCursor++;
+        if (index >= labelWidths.size()) labelWidths.push_back(1);
+
+        auto it = labels.find(valueToken.substr(1));
+        if (it != labels.end()) labelWidths[index] = std::max<uint8_t>(labelWidths[index], narrowestWidth(it->second));
+
+        return std::min<int>(declared, labelWidths[index]);
     }
+
+    return std::min(declared, narrowestWidth(parseNumber(valueToken)));
 }
 
-std::vector<uint8_t> Assembler::autoSizeBytes(const std::string& valueToken) {
+std::vector<uint8_t> Assembler::autoSizeBytes(std::string_view valueToken) {
     std::vector<uint8_t> bytes;
-    std::string num = valueToken;
+    std::string num(valueToken);
 
     while (num != "0" && !num.empty()) {
         int rem = 0;
@@ -151,112 +397,415 @@ std::vector<uint8_t> Assembler::autoSizeBytes(const std::string& valueToken) {
     return bytes;
 }
 
-void Assembler::secondPass(const std::vector<std::string>& lines) {
-    size_t lineNumber = 0;
-    for (const auto& line : lines) {
-        ++lineNumber;
-        if (line.empty()) continue;
+static int dataWidth(std::string_view directive) {
+    if (directive == ".db") return 1;
+    if (directive == ".dw") return 2;
+    if (directive == ".dd") return 4;
+    if (directive == ".dq") return 8;
+    return 0;
+}
+
+// Bytes a data directive takes when placed at address. .align pads up to the next multiple
+// of its operand, counted from the start of the image or object; with -c the object records
+// the largest one and the linker places it on that boundary, so the padding still lines up.
+size_t Assembler::directiveSize(const std::vector<std::string_view>& tokens, uint64_t address) {
+    if (int width = dataWidth(tokens[0])) {
+        if (tokens.size() < 2) error("ASM00010", "Missing values: " + std::string(tokens[0]));
+        return width * (tokens.size() - 1);
+    }
+
+    if (tokens[0] == ".ascii") {
+        size_t size = 0;
+        for (size_t i = 1; i < tokens.size(); i++) size += tokens[i].size();
+        return size;
+    }
+
+    if (tokens[0] == ".align") {
+        uint64_t boundary = tokens.size() < 2 ? 0 : parseNumber(tokens[1]);
+        if (!std::has_single_bit(boundary)) error("ASM00010", ".align needs a power of two");
+        alignment = std::max(alignment, boundary);
+        return (boundary - address % boundary) % boundary;
+    }
+
+    if (tokens[0] == ".fill") {
+        if (tokens.size() < 2) error("ASM00010", ".fill needs a count");
+        return parseNumber(tokens[1]);
+    }
+
+    error("ASM00010", "Unknown directive: " + std::string(tokens[0]));
+    return 0;
+}
 
-        std::vector<std::string> tokens = split(line);
+void Assembler::emitDirective(const std::vector<std::string_view>& tokens, uint8_t*& out) {
+    if (int width = dataWidth(tokens[0])) {
+        for (size_t i = 1; i < tokens.size(); i++) encodeValue(tokens[i], width, out);
+        return;
+    }
+
+    if (tokens[0] == ".ascii") {
+        for (size_t i = 1; i < tokens.size(); i++)
+            for (char c : tokens[i]) *out++ = static_cast<uint8_t>(c);
+        return;
+    }
+
+    uint8_t value = tokens[0] == ".fill" && tokens.size() > 2 ? static_cast<uint8_t>(parseNumber(tokens[2])) : 0x00;
+    size_t size = directiveSize(tokens, out - output.data());
+    for (size_t i = 0; i < size; i++) *out++ = value;
+}
+
+size_t Assembler::lineSize(const std::vector<std::string_view>& tokens, uint64_t address) {
+    if (tokens[0][0] == '!') return 0;
+    if (tokens[0][0] == '.') return directiveSize(tokens, address);
+
+    const Mnemonic* mnemonic = findMnemonic(tokens[0]);
+    if (!mnemonic) return 0;
+
+    switch (mnemonic->encoding) {
+        case ENC_MVAL_PLUS: {
+            if (tokens.size() < 6 || (tokens[4] == "set" && tokens.size() < 7))
+                error("ASM00005", "Missing operands: " + std::string(tokens[0]));
+
+            size_t size = 3 + operandSize(tokens[1]) + 2;
+            if (tokens[4] == "auto") size += autoSizeBytes(tokens[5]).size();
+            else if (tokens[4] == "set") size += (uint16_t)parseNumber(tokens[5]) / 8;
+            return size;
+        }
+
+        case ENC_MVAL_STR:
+            if (tokens.size() < 5) error("ASM00005", "Missing operands: " + std::string(tokens[0]));
+            return 3 + operandSize(tokens[1]) + 2 + tokens[4].size();
+
+        default: {
+            if (tokens.size() < static_cast<size_t>(1 + 2 * mnemonic->operandCount))
+                error("ASM00005", "Missing operands: " + std::string(tokens[0]));
+
+            // parallelAssemble sizes chunks on several threads at once; it is never used with
+            // --optimize-size, so only that path may touch savedBytes.
+            size_t size = mnemonic->opcodeSize + mnemonic->operandCount;
+            for (int i = 1; i <= mnemonic->operandCount; i++) {
+                int encoded = encodedSize(tokens[i], tokens[mnemonic->operandCount + i]);
+                if (optimizeSize) savedBytes += operandSize(tokens[i]) - encoded;
+                size += encoded;
+            }
+            return size;
+        }
+    }
+}
+
+// Lines of the file as the passes see them: the peephole output once peepholePass ran on
+// it, otherwise straight from readFile.
+void Assembler::forEachLine(const std::string& filename, const std::function<void(const std::string&)>& handle) {
+    if (filename != preparedFile) {
+        readFile(filename, handle);
+        return;
+    }
+
+    for (size_t i = 0; i < preparedLines.size(); i++) {
+        location = preparedLocations[i];
+        handle(preparedLines[i]);
+    }
+}
+
+static bool isRegisterOperand(std::string_view type, std::string_view value) {
+    return type == "r8" && !value.empty() && value[0] != '!';
+}
+
+static bool isImmediateOperand(std::string_view type, std::string_view value) {
+    return type.size() > 1 && type[0] == 'i' && std::isdigit(static_cast<unsigned char>(type[1])) && !value.empty() && value[0] != '!';
+}
+
+// True when a flag in mask may still be read after instruction index. The scan stops once
+// every flag in mask is overwritten; labels, jumps, calls, returns and interrupts are
+// treated as reads because the code they lead to is not followed.
+bool Assembler::flagsLiveAfter(const std::vector<std::vector<std::string_view>>& program, size_t index, uint8_t mask) {
+    for (size_t i = index + 1; i < program.size() && mask; i++) {
+        const auto& tokens = program[i];
         if (tokens.empty()) continue;
+        if (tokens[0][0] == '!') return true;
+
+        const Mnemonic* mnemonic = findMnemonic(tokens[0]);
+        if (!mnemonic || (mnemonic->flagsRead & mask)) return true;
+        if (tokens[0] == "stop") return false;
+        if (mnemonic->encoding == ENC_JUMP || tokens[0] == "loop" || tokens[0] == "ret" || tokens[0] == "iret" || tokens[0] == "int") return true;
+
+        mask &= ~mnemonic->flagsWritten;
+    }
+
+    return mask != 0;
+}
+
+// Rewrites one 64 bit register instruction into a cheaper equivalent. replacement is left
+// empty when the instruction can go entirely. A rewrite is only taken when every flag the
+// original or the replacement writes is dead afterwards.
+bool Assembler::peepholeRewrite(const std::vector<std::vector<std::string_view>>& program, size_t index, std::string& replacement) {
+    const auto& tokens = program[index];
+    const Mnemonic* mnemonic = findMnemonic(tokens[0]);
+    if (!mnemonic) return false;
+
+    replacement.clear();
+
+    auto replaceWith = [&](std::string_view name, uint64_t operand) {
+        const Mnemonic* to = findMnemonic(name);
+        if (flagsLiveAfter(program, index, mnemonic->flagsWritten | to->flagsWritten)) return false;
+
+        replacement = std::string(name) + " r8<r8<" + std::string(tokens[3]) + "< "
+                    + std::string(tokens[4]) + " " + std::string(tokens[5]) + " " + std::to_string(operand);
+        return true;
+    };
 
-        if (tokens[0][0] == '!') {
-            std::string name = tokens[0].substr(1, tokens[0].size() - 2);
-            labels.push_back({name, (uint32_t)output.size()});
+    // mval64 r8<r8< a a
+    if (tokens[0] == "mval64") {
+        return tokens.size() >= 5 && isRegisterOperand(tokens[1], tokens[3]) && isRegisterOperand(tokens[2], tokens[4])
+            && parseNumber(tokens[3]) == parseNumber(tokens[4]);
+    }
+
+    // op r8<r8<iN< d s value
+    if (mnemonic->encoding != ENC_THREE || tokens.size() < 7 || !isRegisterOperand(tokens[1], tokens[4])
+        || !isRegisterOperand(tokens[2], tokens[5]) || !isImmediateOperand(tokens[3], tokens[6])) return false;
+
+    uint64_t value = parseNumber(tokens[6]);
+
+    if (tokens[0] == "uadd64" && value == 0) {
+        if (flagsLiveAfter(program, index, mnemonic->flagsWritten)) return false;
+        if (parseNumber(tokens[4]) != parseNumber(tokens[5]))
+            replacement = "mval64 r8<r8< " + std::string(tokens[4]) + " " + std::string(tokens[5]);
+        return true;
+    }
+
+    if (!std::has_single_bit(value)) return false;
+    int shift = std::countr_zero(value);
+
+    if (tokens[0] == "umul64") return replaceWith("shl64", shift);
+    if (tokens[0] == "udiv64") return replaceWith("shr64", shift);
+    if (tokens[0] == "umod64") return replaceWith("and64", value - 1);
+
+    return false;
+}
+
+// Optional pass over the cleaned instruction stream. The result replaces the file for the
+// passes that follow and every applied rewrite is kept for --opt-report.
+void Assembler::peepholePass(const std::string& filename) {
+    std::vector<std::string> lines;
+    std::vector<SourceLocation> locations;
+    readFile(filename, [&](const std::string& line) {
+        lines.push_back(line);
+        locations.push_back(location);
+    });
+
+    std::vector<std::vector<std::string_view>> program(lines.size());
+    for (size_t i = 0; i < lines.size(); i++) split(lines[i], program[i]);
+
+    preparedLines.clear();
+    preparedLocations.clear();
+    rewrites.clear();
+
+    std::string replacement;
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (program[i].empty() || program[i][0][0] == '!' || !peepholeRewrite(program, i, replacement)) {
+            preparedLines.push_back(lines[i]);
+            preparedLocations.push_back(locations[i]);
             continue;
         }
 
-        else if (general0Operands.count(tokens[0])) {
-            output.push_back(general0Operands.at(tokens[0]));
-        }
+        rewrites.push_back({locations[i], lines[i], replacement});
+        if (replacement.empty()) continue;
+
+        preparedLines.push_back(replacement);
+        preparedLocations.push_back(locations[i]);
+    }
+
+    preparedFile = filename;
+}
+
+void Assembler::firstPass(const std::string& filename) {
+    uint64_t address = 0;
+    labels.clear();
+    labelWidths.clear();
+
+    std::vector<std::string_view> tokens;
+    bool changed = true;
+
+    // Without --optimize-size every size is known up front and one pass is enough.
+    while (changed) {
+        decltype(labels) found;
+        address = 0;
+        labelCursor = 0;
+        savedBytes = 0;
+        alignment = 1;
+
+        forEachLine(filename, [&](const std::string& line) {
+            split(line, tokens);
+            if (tokens.empty()) return;
+
+            if (tokens[0][0] == '!') {
+                std::string name(tokens[0].substr(1, tokens[0].size() - 2));
+                if (!found.emplace(name, address).second) error("ASM00009", "Duplicate label: " + name);
+                return;
+            }
+
+            address += lineSize(tokens, address);
+        });
+
+        changed = optimizeSize && found != labels;
+        labels = std::move(found);
+    }
+
+    output.assign(address, 0x00);
+}
+
+void Assembler::secondPass(const std::string& filename) {
+    uint8_t* out = output.data();
+    std::vector<std::string_view> tokens;
+    labelCursor = 0;
+
+    forEachLine(filename, [&](const std::string& line) {
+        split(line, tokens);
+        if (!tokens.empty()) emitLine(tokens, out);
+    });
+
+    if (out != output.data() + output.size()) error("ASM00005", "Emitted size does not match first pass: " + filename);
+}
+
+// Same result as firstPass + secondPass. The cleaned lines are held in memory and split
+// into one chunk per thread: chunks are sized concurrently, placed by a prefix sum, their
+// labels merged in source order, then every chunk is emitted straight into output.
+void Assembler::parallelAssemble(const std::string& filename, int jobs) {
+    std::vector<std::string> lines;
+    forEachLine(filename, [&](const std::string& line) { lines.push_back(line); });
+
+    // .align depends on the absolute address, which a chunk only knows after the prefix sum.
+    if (std::any_of(lines.begin(), lines.end(), [](const std::string& line) { return line.rfind(".align", 0) == 0; })) {
+        firstPass(filename);
+        secondPass(filename);
+        return;
+    }
+
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(jobs, lines.size()));
+    size_t chunkLines = (lines.size() + chunkCount - 1) / chunkCount;
+
+    std::vector<uint64_t> chunkSize(chunkCount, 0);
+    std::vector<uint64_t> chunkBase(chunkCount, 0);
+    std::vector<std::vector<std::pair<std::string, uint64_t>>> chunkLabels(chunkCount);
 
-        else if (general1Operands.count(tokens[0])) {
-            output.push_back(general1Operands.at(tokens[0]));
-            output.push_back(descriptorByte(tokens[1]));
-            encodeOperand(tokens[1], tokens[2]);
+    auto forEachChunk = [&](const std::function<void(size_t, size_t, size_t)>& work) {
+        std::vector<std::thread> threads;
+        for (size_t c = 0; c < chunkCount; c++) {
+            size_t begin = std::min(lines.size(), c * chunkLines);
+            size_t end   = std::min(lines.size(), begin + chunkLines);
+            threads.emplace_back(work, c, begin, end);
         }
+        for (auto& t : threads) t.join();
+    };
+
+    forEachChunk([&](size_t c, size_t begin, size_t end) {
+        std::vector<std::string_view> tokens;
+
+        for (size_t i = begin; i < end; i++) {
+            split(lines[i], tokens);
+            if (tokens.empty()) continue;
+
+            if (tokens[0][0] == '!') {
+                chunkLabels[c].emplace_back(tokens[0].substr(1, tokens[0].size() - 2), chunkSize[c]);
+                continue;
+            }
 
-        else if (general3Operands.count(tokens[0])) {
-            const auto& opcode = general3Operands.at(tokens[0]);
-            for (auto b : opcode) output.push_back(b);
-            output.push_back(descriptorByte(tokens[1]));
-            output.push_back(descriptorByte(tokens[2]));
-            output.push_back(descriptorByte(tokens[3]));
-            encodeOperand(tokens[1], tokens[4]);
-            encodeOperand(tokens[2], tokens[5]);
-            encodeOperand(tokens[3], tokens[6]);
+            chunkSize[c] += lineSize(tokens, chunkSize[c]);
         }
+    });
 
-        else if (general2Operands.count(tokens[0])) {
-            const auto& opcode = general2Operands.at(tokens[0]);
-            for (auto b : opcode) output.push_back(b);
-            output.push_back(descriptorByte(tokens[1]));
-            output.push_back(descriptorByte(tokens[2]));
-            encodeOperand(tokens[1], tokens[3]);
-            encodeOperand(tokens[2], tokens[4]);
+    uint64_t address = 0;
+    labels.clear();
+    for (size_t c = 0; c < chunkCount; c++) {
+        chunkBase[c] = address;
+        address += chunkSize[c];
+
+        for (const auto& [name, offset] : chunkLabels[c])
+            if (!labels.emplace(name, chunkBase[c] + offset).second) error("ASM00009", "Duplicate label: " + name);
+    }
+
+    output.assign(address, 0x00);
+
+    forEachChunk([&](size_t c, size_t begin, size_t end) {
+        uint8_t* out = output.data() + chunkBase[c];
+        std::vector<std::string_view> tokens;
+
+        for (size_t i = begin; i < end; i++) {
+            split(lines[i], tokens);
+            if (!tokens.empty()) emitLine(tokens, out);
         }
 
-        else if (tokens[0] == "mval64plus") {
-            output.push_back(0x14);
-            output.push_back(descriptorByte(tokens[1]));
-            output.push_back(descriptorByte(tokens[2]));
-            encodeOperand(tokens[1], tokens[3]);
+        if (out != output.data() + chunkBase[c] + chunkSize[c]) error("ASM00005", "Emitted size does not match first pass: " + filename);
+    });
+}
+
+void Assembler::emitLine(const std::vector<std::string_view>& tokens, uint8_t*& out) {
+    if (tokens[0][0] == '!') return;
+
+    if (tokens[0][0] == '.') {
+        emitDirective(tokens, out);
+        return;
+    }
+
+    const Mnemonic* mnemonic = findMnemonic(tokens[0]);
+    if (!mnemonic) return;
+
+    for (int i = 0; i < mnemonic->opcodeSize; i++) *out++ = mnemonic->opcode[i];
+
+    switch (mnemonic->encoding) {
+        case ENC_MVAL_PLUS:
+            *out++ = descriptorByte(tokens[1]);
+            *out++ = descriptorByte(tokens[2]);
+            encodeOperand(tokens[1], tokens[3], out);
 
             if (tokens[4] == "auto") {
                 auto bytes = autoSizeBytes(tokens[5]);
                 uint16_t size = bytes.size();
-                output.push_back(size & 0xFF);
-                output.push_back((size >> 8) & 0xFF);
-                for (auto b : bytes) output.push_back(b);
+                *out++ = size & 0xFF;
+                *out++ = (size >> 8) & 0xFF;
+                for (auto b : bytes) *out++ = b;
 
             } else if (tokens[4] == "set") {
-                uint16_t size = (uint16_t)std::stoull(tokens[5], nullptr, 0) / 8;
-                output.push_back(size & 0xFF);
-                output.push_back((size >> 8) & 0xFF);
+                uint16_t size = (uint16_t)parseNumber(tokens[5]) / 8;
+                *out++ = size & 0xFF;
+                *out++ = (size >> 8) & 0xFF;
                 auto bytes = autoSizeBytes(tokens[6]);
                 bytes.resize(size, 0);
-                for (auto b : bytes) output.push_back(b);
+                for (auto b : bytes) *out++ = b;
             }
-        }
-
-        else if (tokens[0] == "mvalstr") {
-            output.push_back(0x14);
-            output.push_back(descriptorByte(tokens[1]));
-            output.push_back(descriptorByte(tokens[2]));
+            break;
 
-            encodeOperand(tokens[1], tokens[3]);
+        case ENC_MVAL_STR: {
+            *out++ = descriptorByte(tokens[1]);
+            *out++ = descriptorByte(tokens[2]);
+            encodeOperand(tokens[1], tokens[3], out);
 
-            std::string str = tokens[4];
+            std::string_view str = tokens[4];
             uint16_t size = str.size();
-            output.push_back(size & 0xFF);
-            output.push_back((size >> 8) & 0xFF);
-            for (char c : str) output.push_back((uint8_t)c);
+            *out++ = size & 0xFF;
+            *out++ = (size >> 8) & 0xFF;
+            for (char c : str) *out++ = (uint8_t)c;
+            break;
         }
 
-        else if (generalJumps.count(tokens[0])) {
-            output.push_back(generalJumps.at(tokens[0]));
-            output.push_back(descriptorByte(tokens[1]));
-            if (tokens[2][0] == '!') {
-                std::string name = tokens[2].substr(1);
-                uint64_t addr = 0;
-                for (const auto& l : labels)
-                    if (l.name == name) { addr = l.address; break; }
-                for (int b = 0; b < 8; b++) output.push_back((addr >> (b * 8)) & 0xFF);
-            } else {
-                encodeOperand(tokens[1], tokens[2]);
+        default: {
+            if (!optimizeSize) {
+                for (int i = 1; i <= mnemonic->operandCount; i++)
+                    *out++ = descriptorByte(tokens[i]);
+                for (int i = 1; i <= mnemonic->operandCount; i++)
+                    encodeOperand(tokens[i], tokens[mnemonic->operandCount + i], out);
+                break;
             }
-        }
 
-        else if (general4Operands.count(tokens[0])) {
-            output.push_back(general4Operands.at(tokens[0]));
-            output.push_back(descriptorByte(tokens[1]));
-            output.push_back(descriptorByte(tokens[2]));
-            output.push_back(descriptorByte(tokens[3]));
-            output.push_back(descriptorByte(tokens[4]));
-            encodeOperand(tokens[1], tokens[5]);
-            encodeOperand(tokens[2], tokens[6]);
-            encodeOperand(tokens[3], tokens[7]);
-            encodeOperand(tokens[4], tokens[8]);
+            int sizes[4];
+            for (int i = 1; i <= mnemonic->operandCount; i++) {
+                std::string_view type = tokens[i];
+                sizes[i - 1] = encodedSize(type, tokens[mnemonic->operandCount + i]);
+                *out++ = narrowable(type) ? narrowedDescriptor(type, sizes[i - 1]) : descriptorByte(type);
+            }
+            for (int i = 1; i <= mnemonic->operandCount; i++)
+                encodeValue(tokens[mnemonic->operandCount + i], sizes[i - 1], out);
+            break;
         }
     }
 }
@@ -268,35 +817,337 @@ void Assembler::writeOutput(const std::string& filename) {
     f.close();
 }
 
-int main() {
-    std::string inputFile, outputFile;
+// Address, encoded bytes and source line of everything in output. The lines are sized once
+// more after the passes, so the listing matches whichever path built output.
+void Assembler::writeListing(const std::string& filename, const std::string& listingFile) {
+    std::ofstream f(listingFile, std::ios::trunc);
+    if (!f) error("ASM00007", listingFile);
 
-    std::cout << "Enter assembly file path: ";
-    std::getline(std::cin, inputFile);
-    if (inputFile.empty()) inputFile = "asmFile.trasm";
+    f << "; " << filename << "\n; address   bytes                     source\n";
 
-    std::cout << "Enter output file path: ";
-    std::getline(std::cin, outputFile);
-    if (outputFile.empty()) outputFile = "rom.bin";
+    std::vector<std::string_view> tokens;
+    uint64_t address = 0;
+    uint64_t saved = savedBytes;
+    labelCursor = 0;
+    char row[64];
 
-    std::vector<std::string> lines;
-    try {
-        lines = assembler.readFile(inputFile);
-    } catch (const std::exception& e) {
-        assembler.error("ASM00001", e.what());
+    forEachLine(filename, [&](const std::string& line) {
+        split(line, tokens);
+        if (tokens.empty()) return;
+
+        size_t size = lineSize(tokens, address);
+        std::string source = location.file ? *location.file + ":" + std::to_string(location.line) : "";
+
+        // Eight bytes per row, long data continues on rows of its own.
+        size_t offset = 0;
+        do {
+            int n = std::snprintf(row, sizeof(row), "%08llx  ", static_cast<unsigned long long>(address + offset));
+            for (size_t i = 0; i < 8; i++) {
+                if (offset + i < size) n += std::snprintf(row + n, sizeof(row) - n, "%02x ", output[address + offset + i]);
+                else n += std::snprintf(row + n, sizeof(row) - n, "   ");
+            }
+
+            std::string text = row;
+            if (offset == 0) text += " " + source + "  " + line;
+            else text.erase(text.find_last_not_of(' ') + 1);
+            f << text << "\n";
+            offset += 8;
+        } while (offset < size);
+
+        address += size;
+    });
+
+    savedBytes = saved;
+    if (!f) error("ASM00007", listingFile);
+}
+
+void Assembler::writeMap(const std::string& mapFile) {
+    if (!writeSymbolMap(mapFile, buildSymbolMap(labels, output.size()))) error("ASM00007", mapFile);
+}
+
+static void printUsage() {
+    std::cerr << "Usage: assembler <input.trasm> [output.bin] [-o output.bin] [-I dir]... [--no-pad] [-j threads] [-c]\n"
+              << "       assembler <a.trasm> <b.trasm>... --cache <dir> [-o output.bin] [-I dir]... [--no-pad] [-j threads]\n"
+              << "  -o <file>   Output file (default rom.bin)\n"
+              << "  -I <dir>    Extra directory searched by .include\n"
+              << "  --no-pad    Do not pad the output to 32KB\n"
+              << "  -j <n>      Assemble with n threads (0 = all cores), same output as -j 1\n"
+              << "  -c          Write a relocatable object (.tro) for the linker instead of an image\n"
+              << "  --optimize-size  Encode every immediate, address and label with the narrowest\n"
+              << "              descriptor that holds it and report the bytes saved\n"
+              << "  --peephole  Rewrite instructions into cheaper equivalents where the flags they\n"
+              << "              change are overwritten before anything reads them\n"
+              << "  --opt-report  Same as --peephole and lists every rewrite it applied\n"
+              << "  --listing <f>  Write address, bytes and source line of every line to f\n"
+              << "  --map <f>   Write the label map (address, size, name) to f\n"
+              << "  --cache <d> Incremental build: one cached object per input, only changed files are\n"
+              << "              assembled again, then everything is relinked into the image\n"
+              << "Without arguments the assembler asks for the paths.\n"
+              << "Exit codes: 0 done, 1 assembly error, 2 bad arguments.\n";
+}
+
+ObjectFile Assembler::makeObject() {
+    ObjectFile object;
+    object.sections.push_back({"text", output, alignment});
+
+    std::unordered_map<std::string, uint32_t, LabelHash, std::equal_to<>> symbolIndex;
+
+    for (const auto& [name, address] : labels)
+        object.symbols.push_back({name, 0, address});
+
+    std::sort(object.symbols.begin(), object.symbols.end(), [](const ObjectSymbol& a, const ObjectSymbol& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.name < b.name;
+    });
+
+    std::vector<std::string> imports;
+    for (const auto& ref : labelReferences)
+        if (!labels.count(ref.name)) imports.push_back(ref.name);
+
+    std::sort(imports.begin(), imports.end());
+    imports.erase(std::unique(imports.begin(), imports.end()), imports.end());
+    for (const auto& name : imports)
+        object.symbols.push_back({name, OBJECT_UNDEFINED, 0});
+
+    for (uint32_t i = 0; i < object.symbols.size(); i++)
+        symbolIndex.emplace(object.symbols[i].name, i);
+
+    for (const auto& ref : labelReferences)
+        object.relocations.push_back({0, ref.offset, ref.size, symbolIndex.at(ref.name)});
+
+    return object;
+}
+
+void Assembler::writeObject(const std::string& filename) {
+    if (!writeObjectFile(filename, makeObject())) error("ASM00007", filename);
+}
+
+// FNV-1a over the cleaned lines (includes expanded) and the options that change encoding,
+// so comment and whitespace edits keep the cached object.
+uint64_t Assembler::sourceHash(const std::string& filename, const std::string& options) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&](std::string_view text) {
+        for (char c : text) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+    };
+
+    mix(options);
+    readFile(filename, [&](const std::string& line) {
+        mix(line);
+        mix("\n");
+    });
+
+    return hash;
+}
+
+static void printOptReport(const std::string& filename, const std::vector<PeepholeRewrite>& rewrites) {
+    std::cout << filename << ": " << rewrites.size() << " peephole rewrite" << (rewrites.size() == 1 ? "" : "s") << "\n";
+    for (const auto& r : rewrites)
+        std::cout << "  " << *r.location.file << ":" << r.location.line << ": " << r.before << "  ->  " << (r.after.empty() ? "(removed)" : r.after) << "\n";
+}
+
+static std::string hex64(uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text(16, '0');
+    for (int i = 15; i >= 0; i--, value >>= 4) text[i] = digits[value & 0xF];
+    return text;
+}
+
+// Assembles every input into its own object, reusing the cached object of any file whose
+// content hash did not change, then links them in process.
+static void incrementalBuild(const std::vector<std::string>& inputs, const std::string& cacheDir, const std::string& options, int jobs, bool optReport, Linker& linker) {
+    namespace fs = std::filesystem;
+    fs::create_directories(cacheDir);
+
+    struct Unit {
+        std::string input;
+        std::string objectPath;
+        std::string hashPath;
+        std::string hash;
+        bool cached = false;
+        ObjectFile object;
+        std::vector<PeepholeRewrite> rewrites;
+    };
+
+    std::vector<Unit> units(inputs.size());
+    std::vector<size_t> stale;
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        Unit& unit = units[i];
+        unit.input = inputs[i];
+
+        std::string key = fs::path(inputs[i]).stem().string() + "-" + hex64(std::hash<std::string>{}(fs::absolute(inputs[i]).string())).substr(0, 8);
+        unit.objectPath = (fs::path(cacheDir) / (key + ".tro")).string();
+        unit.hashPath   = (fs::path(cacheDir) / (key + ".hash")).string();
+        unit.hash       = hex64(assembler.sourceHash(inputs[i], options));
+
+        std::ifstream previous(unit.hashPath);
+        std::string previousHash;
+        if (previous >> previousHash && previousHash == unit.hash && readObjectFile(unit.objectPath, unit.object))
+            unit.cached = true;
+        else
+            stale.push_back(i);
+    }
+
+    auto assembleUnit = [&](Unit& unit) {
+        Assembler fileAssembler;
+        fileAssembler.objectMode = true;
+        fileAssembler.includePaths = assembler.includePaths;
+        fileAssembler.optimizeSize = assembler.optimizeSize;
+        fileAssembler.peephole = assembler.peephole;
+        if (fileAssembler.peephole) fileAssembler.peepholePass(unit.input);
+        fileAssembler.firstPass(unit.input);
+        fileAssembler.secondPass(unit.input);
+        unit.object = fileAssembler.makeObject();
+        unit.rewrites = std::move(fileAssembler.rewrites);
+
+        if (!writeObjectFile(unit.objectPath, unit.object)) assembler.error("ASM00007", unit.objectPath);
+        std::ofstream(unit.hashPath, std::ios::trunc) << unit.hash << "\n";
+    };
+
+    for (size_t first = 0; first < stale.size(); first += jobs) {
+        std::vector<std::thread> threads;
+        for (size_t i = first; i < stale.size() && i < first + jobs; i++)
+            threads.emplace_back(assembleUnit, std::ref(units[stale[i]]));
+        for (auto& t : threads) t.join();
     }
 
-    std::cout << "Assembling...\n";
+    if (optReport)
+        for (size_t i : stale) printOptReport(units[i].input, units[i].rewrites);
+
+    for (auto& unit : units) linker.add(unit.input, std::move(unit.object));
+    linker.link();
+
+    std::cout << "Reused " << inputs.size() - stale.size() << " of " << inputs.size() << " objects, assembled " << stale.size() << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string inputFile, outputFile, cacheDir, listingFile, mapFile;
+    std::vector<std::string> inputs;
+    bool pad = true;
+    int jobs = 1;
+    bool optReport = false;
+    bool interactive = argc < 2;
+
+    if (interactive) {
+        std::cout << "Enter assembly file path: ";
+        std::getline(std::cin, inputFile);
+        if (inputFile.empty()) inputFile = "asmFile.trasm";
+
+        std::cout << "Enter output file path: ";
+        std::getline(std::cin, outputFile);
+
+    } else {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg == "-h" || arg == "--help") {
+                printUsage();
+                return 0;
+            }
+
+            else if (arg == "-o" && i + 1 < argc) outputFile = argv[++i];
+            else if (arg == "-I" && i + 1 < argc) assembler.includePaths.push_back(argv[++i]);
+            else if (arg.rfind("-I", 0) == 0 && arg.size() > 2) assembler.includePaths.push_back(arg.substr(2));
+            else if (arg == "--no-pad") pad = false;
+            else if (arg == "--pad") pad = true;
+            else if (arg == "-c") assembler.objectMode = true;
+            else if (arg == "--optimize-size" || arg == "-Os") assembler.optimizeSize = true;
+            else if (arg == "--peephole") assembler.peephole = true;
+            else if (arg == "--opt-report") assembler.peephole = optReport = true;
+            else if (arg == "-j" && i + 1 < argc) jobs = std::atoi(argv[++i]);
+            else if (arg.rfind("-j", 0) == 0 && arg.size() > 2) jobs = std::atoi(arg.c_str() + 2);
+            else if (arg == "--cache" && i + 1 < argc) cacheDir = argv[++i];
+            else if (arg == "--listing" && i + 1 < argc) listingFile = argv[++i];
+            else if (arg == "--map" && i + 1 < argc) mapFile = argv[++i];
+
+            else if (arg[0] != '-') inputs.push_back(arg);
+
+            else {
+                std::cerr << "Unexpected argument: " << arg << "\n";
+                printUsage();
+                return 2;
+            }
+        }
+
+        if (inputs.empty() || (cacheDir.empty() && inputs.size() > 2) || (!cacheDir.empty() && (assembler.objectMode || !listingFile.empty()))) {
+            printUsage();
+            return 2;
+        }
+
+        if (cacheDir.empty()) {
+            inputFile = inputs[0];
+            if (inputs.size() == 2) {
+                if (!outputFile.empty()) {
+                    printUsage();
+                    return 2;
+                }
+                outputFile = inputs[1];
+            }
+        }
+    }
+
+    if (outputFile.empty()) outputFile = assembler.objectMode ? std::filesystem::path(inputFile).replace_extension(".tro").string() : "rom.bin";
+
+    if (interactive) std::cout << "Assembling...\n";
+
+    if (jobs <= 0) jobs = std::max(1u, std::thread::hardware_concurrency());
 
-    assembler.secondPass(lines);
     const size_t ROM_SIZE = 32 * 1024;
-    while (assembler.output.size() < ROM_SIZE)
-        assembler.output.push_back(0x00);
+
+    if (!cacheDir.empty()) {
+        std::string options;
+        for (const auto& dir : assembler.includePaths) options += "-I" + dir + "\n";
+        if (assembler.optimizeSize) options += "--optimize-size\n";
+        if (assembler.peephole) options += "--peephole\n";
+
+        Linker linker;
+        incrementalBuild(inputs, cacheDir, options, jobs, optReport, linker);
+
+        if (!mapFile.empty() && !writeSymbolMap(mapFile, buildSymbolMap(linker.symbols, linker.base + linker.image.size())))
+            assembler.error("ASM00007", mapFile);
+
+        if (pad) {
+            if (linker.image.size() > ROM_SIZE) linker.error("LNK00005", std::to_string(linker.image.size()) + " bytes");
+            linker.image.resize(ROM_SIZE, 0x00);
+        }
+
+        linker.writeImage(outputFile);
+        std::cout << "Done! " << linker.image.size() << " bytes written to " << outputFile << (pad ? " (padded to 32KB)\n" : "\n");
+        return 0;
+    }
+
+    if (assembler.peephole) {
+        assembler.peepholePass(inputFile);
+        if (optReport) printOptReport(inputFile, assembler.rewrites);
+    }
+
+    if (jobs > 1 && !assembler.objectMode && !assembler.optimizeSize) {
+        assembler.parallelAssemble(inputFile, jobs);
+    } else {
+        assembler.firstPass(inputFile);
+        assembler.secondPass(inputFile);
+    }
+
+    if (assembler.optimizeSize)
+        std::cout << "Optimised for size: " << assembler.savedBytes << " bytes saved\n";
+
+    if (!listingFile.empty()) assembler.writeListing(inputFile, listingFile);
+    if (!mapFile.empty()) assembler.writeMap(mapFile);
+
+    if (assembler.objectMode) {
+        assembler.writeObject(outputFile);
+        std::cout << "Done! " << assembler.output.size() << " bytes of code written to " << outputFile << "\n";
+        return 0;
+    }
+
+    if (pad && assembler.output.size() < ROM_SIZE)
+        assembler.output.resize(ROM_SIZE, 0x00);
 
     assembler.writeOutput(outputFile);
-    std::cout << "Done! Written to " << outputFile << " (padded to 32KB)\n";
+    std::cout << "Done! " << assembler.output.size() << " bytes written to " << outputFile << (pad ? " (padded to 32KB)\n" : "\n");
 
-    std::cout << "Done! " << assembler.output.size() << " bytes written to " << outputFile << "\n";
-    std::cin.get();
+    if (interactive) std::cin.get();
     return 0;
 }
\ No newline at end of file
@@ -1,138 +1,546 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
 #include <cstdint>
 #include <unordered_map>
+#include <functional>
+#include <unordered_set>
+#include "objectFile.h"
+#include "symbolMap.h"
 
-struct Label {
-    std::string name;
-    uint32_t address;
+enum EncodingClass : uint8_t {
+    ENC_NONE,
+    ENC_ONE,
+    ENC_TWO,
+    ENC_THREE,
+    ENC_FOUR,
+    ENC_JUMP,
+    ENC_MVAL_PLUS,
+    ENC_MVAL_STR
 };
 
-static const std::unordered_map<std::string, uint8_t> general0Operands = {
-    {"nac",   0x00},
-    {"ret",   0xAF},
-    {"pusha", 0xB8},
-    {"popa",  0xB9},
-    {"pushf", 0xBA},
-    {"popf",  0xBB},
-    {"clc",   0xBC},
-    {"stc",   0xBD},
-    {"cld",   0xBE},
-    {"std",   0xBF},
-    {"cli",   0xC0},
-    {"sti",   0xC1},
-    {"clo",   0xC2},
-    {"enter", 0xDE},
-    {"leave", 0xDF},
-    {"iret",  0xE7},
-    {"wait",  0xFC},
-    {"stop",  0xFD},
+struct Mnemonic {
+    std::string_view name;
+    uint8_t opcode[2];
+    uint8_t opcodeSize;
+    uint8_t operandCount;
+    EncodingClass encoding;
+    uint8_t flagsRead;      // CPU::flagNames bits the instruction reads
+    uint8_t flagsWritten;   // and the ones it overwrites
 };
 
-static const std::unordered_map<std::string, uint8_t> generalJumps = {
-    {"jmp", 0x9C},
-    {"jz",  0x9D}, {"jnz", 0x9E},
-    {"jl",  0x9F}, {"jg",  0xA0}, {"jle", 0xA1}, {"jge", 0xA2},
-    {"jb",  0xA3}, {"ja",  0xA4}, {"jbe", 0xA5}, {"jae", 0xA6},
-    {"jo",  0xA7}, {"jno", 0xA8},
-    {"js",  0xA9}, {"jns", 0xAA},
-    {"jc",  0xAB}, {"jnc", 0xAC},
-    {"call",0xAE},
+static constexpr Mnemonic mnemonicTable[] = {
+    // No operands
+    {"nac",        {0x00},      1, 0, ENC_NONE,      0x00, 0x00},
+    {"ret",        {0xAF},      1, 0, ENC_NONE,      0x00, 0x00},
+    {"pusha",      {0xB8},      1, 0, ENC_NONE,      0x00, 0x00},
+    {"popa",       {0xB9},      1, 0, ENC_NONE,      0x00, 0x00},
+    {"pushf",      {0xBA},      1, 0, ENC_NONE,      0xFF, 0x00},
+    {"popf",       {0xBB},      1, 0, ENC_NONE,      0x00, 0xFF},
+    {"clc",        {0xBC},      1, 0, ENC_NONE,      0x00, 0x80},
+    {"stc",        {0xBD},      1, 0, ENC_NONE,      0x00, 0x80},
+    {"cld",        {0xBE},      1, 0, ENC_NONE,      0x00, 0x02},
+    {"std",        {0xBF},      1, 0, ENC_NONE,      0x00, 0x02},
+    {"cli",        {0xC0},      1, 0, ENC_NONE,      0x00, 0x08},
+    {"sti",        {0xC1},      1, 0, ENC_NONE,      0x00, 0x08},
+    {"clo",        {0xC2},      1, 0, ENC_NONE,      0x00, 0x10},
+    {"enter",      {0xDE},      1, 0, ENC_NONE,      0x00, 0x00},
+    {"leave",      {0xDF},      1, 0, ENC_NONE,      0x00, 0x00},
+    {"iret",       {0xE7},      1, 0, ENC_NONE,      0x00, 0xFF},
+    {"wait",       {0xFC},      1, 0, ENC_NONE,      0x00, 0x04},
+    {"stop",       {0xFD},      1, 0, ENC_NONE,      0x00, 0x00},
+
+    // Jumps
+    {"jmp",        {0x9C},      1, 1, ENC_JUMP,      0x00, 0x00},
+    {"jz",         {0x9D},      1, 1, ENC_JUMP,      0x40, 0x00},
+    {"jnz",        {0x9E},      1, 1, ENC_JUMP,      0x40, 0x00},
+    {"jl",         {0x9F},      1, 1, ENC_JUMP,      0x30, 0x00},
+    {"jg",         {0xA0},      1, 1, ENC_JUMP,      0x70, 0x00},
+    {"jle",        {0xA1},      1, 1, ENC_JUMP,      0x70, 0x00},
+    {"jge",        {0xA2},      1, 1, ENC_JUMP,      0x30, 0x00},
+    {"jb",         {0xA3},      1, 1, ENC_JUMP,      0x80, 0x00},
+    {"ja",         {0xA4},      1, 1, ENC_JUMP,      0xC0, 0x00},
+    {"jbe",        {0xA5},      1, 1, ENC_JUMP,      0xC0, 0x00},
+    {"jae",        {0xA6},      1, 1, ENC_JUMP,      0x80, 0x00},
+    {"jo",         {0xA7},      1, 1, ENC_JUMP,      0x10, 0x00},
+    {"jno",        {0xA8},      1, 1, ENC_JUMP,      0x10, 0x00},
+    {"js",         {0xA9},      1, 1, ENC_JUMP,      0x20, 0x00},
+    {"jns",        {0xAA},      1, 1, ENC_JUMP,      0x20, 0x00},
+    {"jc",         {0xAB},      1, 1, ENC_JUMP,      0x80, 0x00},
+    {"jnc",        {0xAC},      1, 1, ENC_JUMP,      0x80, 0x00},
+    {"call",       {0xAE},      1, 1, ENC_JUMP,      0x00, 0x00},
+
+    // One operand
+    {"inc8",       {0x35},      1, 1, ENC_ONE,       0x00, 0x40},
+    {"inc16",      {0x36},      1, 1, ENC_ONE,       0x00, 0x40},
+    {"inc32",      {0x37},      1, 1, ENC_ONE,       0x00, 0x40},
+    {"inc64",      {0x38},      1, 1, ENC_ONE,       0x00, 0x40},
+    {"dec8",       {0x39},      1, 1, ENC_ONE,       0x00, 0x40},
+    {"dec16",      {0x3A},      1, 1, ENC_ONE,       0x00, 0x40},
+    {"dec32",      {0x3B},      1, 1, ENC_ONE,       0x00, 0x40},
+    {"dec64",      {0x3C},      1, 1, ENC_ONE,       0x00, 0x40},
+    {"neg8",       {0x45},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"neg16",      {0x46},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"neg32",      {0x47},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"neg64",      {0x48},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"abs8",       {0x98},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"abs16",      {0x99},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"abs32",      {0x9A},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"abs64",      {0x9B},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"bnot8",      {0x61},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"bnot16",     {0x62},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"bnot32",     {0x63},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"bnot64",     {0x64},      1, 1, ENC_ONE,       0x00, 0xF0},
+    {"bswap16",    {0x85},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"bswap32",    {0x86},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"bswap64",    {0x87},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"push8",      {0xB0},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"push16",     {0xB1},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"push32",     {0xB2},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"push64",     {0xB3},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"pop8",       {0xB4},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"pop16",      {0xB5},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"pop32",      {0xB6},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"pop64",      {0xB7},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"sleepms",    {0xFE},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"sleepsec",   {0xFF},      1, 1, ENC_ONE,       0x00, 0x00},
+    {"int",        {0xE6},      1, 1, ENC_ONE,       0x00, 0x00},
+
+    // Two operands
+    {"mval8",      {0x10},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"mval16",     {0x11},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"mval32",     {0x12},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"mval64",     {0x13},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"scmp8",      {0x49},      1, 2, ENC_TWO,       0x00, 0x70},
+    {"ucmp8",      {0x4A},      1, 2, ENC_TWO,       0x00, 0xC0},
+    {"scmp16",     {0x4B},      1, 2, ENC_TWO,       0x00, 0x70},
+    {"ucmp16",     {0x4C},      1, 2, ENC_TWO,       0x00, 0xC0},
+    {"scmp32",     {0x4D},      1, 2, ENC_TWO,       0x00, 0x70},
+    {"ucmp32",     {0x4E},      1, 2, ENC_TWO,       0x00, 0xC0},
+    {"scmp64",     {0x4F},      1, 2, ENC_TWO,       0x00, 0x70},
+    {"ucmp64",     {0x50},      1, 2, ENC_TWO,       0x00, 0xC0},
+    {"test8",      {0x51},      1, 2, ENC_TWO,       0x00, 0xF0},
+    {"test16",     {0x52},      1, 2, ENC_TWO,       0x00, 0xF0},
+    {"test32",     {0x53},      1, 2, ENC_TWO,       0x00, 0xF0},
+    {"test64",     {0x54},      1, 2, ENC_TWO,       0x00, 0xF0},
+    {"btst8",      {0x81},      1, 2, ENC_TWO,       0x00, 0xF0},
+    {"btst16",     {0x82},      1, 2, ENC_TWO,       0x00, 0xF0},
+    {"btst32",     {0x83},      1, 2, ENC_TWO,       0x00, 0xF0},
+    {"btst64",     {0x84},      1, 2, ENC_TWO,       0x00, 0xF0},
+    {"loop",       {0xAD},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"xchg",       {0xC3},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"sext8",      {0xE0},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"sext16",     {0xE1},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"sext32",     {0xE2},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"zext8",      {0xE3},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"zext16",     {0xE4},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"zext32",     {0xE5},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"in8",        {0xE8},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"in16",       {0xE9},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"in32",       {0xEA},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"in64",       {0xEB},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"out8",       {0xEC},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"out16",      {0xED},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"out32",      {0xEE},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"out64",      {0xEF},      1, 2, ENC_TWO,       0x00, 0x00},
+    {"popcnt8",    {0x01,0x14}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"popcnt16",   {0x01,0x15}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"popcnt32",   {0x01,0x16}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"popcnt64",   {0x01,0x17}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"clz8",       {0x01,0x18}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"clz16",      {0x01,0x19}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"clz32",      {0x01,0x1A}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"clz64",      {0x01,0x1B}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"ctz8",       {0x01,0x1C}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"ctz16",      {0x01,0x1D}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"ctz32",      {0x01,0x1E}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"ctz64",      {0x01,0x1F}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"bsf8",       {0x01,0x20}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"bsf16",      {0x01,0x21}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"bsf32",      {0x01,0x22}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"bsf64",      {0x01,0x23}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"bsr8",       {0x01,0x24}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"bsr16",      {0x01,0x25}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"bsr32",      {0x01,0x26}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"bsr64",      {0x01,0x27}, 2, 2, ENC_TWO,       0x00, 0xF0},
+    {"vld",        {0x02,0x21}, 2, 2, ENC_TWO,       0x00, 0x00},
+    {"vst",        {0x02,0x22}, 2, 2, ENC_TWO,       0x00, 0x00},
+    {"mval64plus", {0x14},      1, 2, ENC_MVAL_PLUS, 0x00, 0x00},
+    {"mvalstr",    {0x14},      1, 2, ENC_MVAL_STR,  0x00, 0x00},
+
+    // Three operands
+    {"sadd8",      {0x15},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"uadd8",      {0x16},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"sadd16",     {0x17},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"uadd16",     {0x18},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"sadd32",     {0x19},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"uadd32",     {0x1A},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"sadd64",     {0x1B},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"uadd64",     {0x1C},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"ssub8",      {0x1D},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"usub8",      {0x1E},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"ssub16",     {0x1F},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"usub16",     {0x20},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"ssub32",     {0x21},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"usub32",     {0x22},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"ssub64",     {0x23},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"usub64",     {0x24},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"smul8",      {0x25},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"umul8",      {0x26},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"smul16",     {0x27},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"umul16",     {0x28},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"smul32",     {0x29},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"umul32",     {0x2A},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"smul64",     {0x2B},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"umul64",     {0x2C},      1, 3, ENC_THREE,     0x00, 0xC0},
+    {"sdiv8",      {0x2D},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"udiv8",      {0x2E},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"sdiv16",     {0x2F},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"udiv16",     {0x30},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"sdiv32",     {0x31},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"udiv32",     {0x32},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"sdiv64",     {0x33},      1, 3, ENC_THREE,     0x00, 0x70},
+    {"udiv64",     {0x34},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smod8",      {0x3D},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umod8",      {0x3E},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smod16",     {0x3F},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umod16",     {0x40},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smod32",     {0x41},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umod32",     {0x42},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smod64",     {0x43},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umod64",     {0x44},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"and8",       {0x55},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"and16",      {0x56},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"and32",      {0x57},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"and64",      {0x58},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"or8",        {0x59},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"or16",       {0x5A},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"or32",       {0x5B},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"or64",       {0x5C},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"xor8",       {0x5D},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"xor16",      {0x5E},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"xor32",      {0x5F},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"xor64",      {0x60},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"shl8",       {0x65},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"shl16",      {0x66},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"shl32",      {0x67},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"shl64",      {0x68},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"shr8",       {0x69},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"shr16",      {0x6A},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"shr32",      {0x6B},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"shr64",      {0x6C},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"sar8",       {0x6D},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"sar16",      {0x6E},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"sar32",      {0x6F},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"sar64",      {0x70},      1, 3, ENC_THREE,     0x00, 0xE0},
+    {"andn8",      {0x71},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"andn16",     {0x72},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"andn32",     {0x73},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"andn64",     {0x74},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bset8",      {0x75},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bset16",     {0x76},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bset32",     {0x77},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bset64",     {0x78},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bclr8",      {0x79},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bclr16",     {0x7A},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bclr32",     {0x7B},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bclr64",     {0x7C},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bflip8",     {0x7D},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bflip16",    {0x7E},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bflip32",    {0x7F},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"bflip64",    {0x80},      1, 3, ENC_THREE,     0x00, 0xF0},
+    {"sadc8",      {0x88},      1, 3, ENC_THREE,     0x80, 0x70},
+    {"uadc8",      {0x89},      1, 3, ENC_THREE,     0x80, 0xC0},
+    {"sadc16",     {0x8A},      1, 3, ENC_THREE,     0x80, 0x70},
+    {"uadc16",     {0x8B},      1, 3, ENC_THREE,     0x80, 0xC0},
+    {"sadc32",     {0x8C},      1, 3, ENC_THREE,     0x80, 0x70},
+    {"uadc32",     {0x8D},      1, 3, ENC_THREE,     0x80, 0xC0},
+    {"sadc64",     {0x8E},      1, 3, ENC_THREE,     0x80, 0x70},
+    {"uadc64",     {0x8F},      1, 3, ENC_THREE,     0x80, 0xC0},
+    {"ssbc8",      {0x90},      1, 3, ENC_THREE,     0x80, 0x70},
+    {"usbc8",      {0x91},      1, 3, ENC_THREE,     0x80, 0xC0},
+    {"ssbc16",     {0x92},      1, 3, ENC_THREE,     0x80, 0x70},
+    {"usbc16",     {0x93},      1, 3, ENC_THREE,     0x80, 0xC0},
+    {"ssbc32",     {0x94},      1, 3, ENC_THREE,     0x80, 0x70},
+    {"usbc32",     {0x95},      1, 3, ENC_THREE,     0x80, 0xC0},
+    {"ssbc64",     {0x96},      1, 3, ENC_THREE,     0x80, 0x70},
+    {"usbc64",     {0x97},      1, 3, ENC_THREE,     0x80, 0xC0},
+    {"smulhi64",   {0xC4},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umulhi64",   {0xC5},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smin8",      {0xC6},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umin8",      {0xC7},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smax8",      {0xC8},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umax8",      {0xC9},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smin16",     {0xCA},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umin16",     {0xCB},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smax16",     {0xCC},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umax16",     {0xCD},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smin32",     {0xCE},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umin32",     {0xCF},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smax32",     {0xD0},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umax32",     {0xD1},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smin64",     {0xD2},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umin64",     {0xD3},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"smax64",     {0xD4},      1, 3, ENC_THREE,     0x00, 0x60},
+    {"umax64",     {0xD5},      1, 3, ENC_THREE,     0x00, 0x40},
+    {"nand8",      {0x01,0x00}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"nand16",     {0x01,0x01}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"nand32",     {0x01,0x02}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"nand64",     {0x01,0x03}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"nor8",       {0x01,0x04}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"nor16",      {0x01,0x05}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"nor32",      {0x01,0x06}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"nor64",      {0x01,0x07}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"xnor8",      {0x01,0x08}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"xnor16",     {0x01,0x09}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"xnor32",     {0x01,0x0A}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"xnor64",     {0x01,0x0B}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"rol8",       {0x01,0x0C}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"rol16",      {0x01,0x0D}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"rol32",      {0x01,0x0E}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"rol64",      {0x01,0x0F}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"ror8",       {0x01,0x10}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"ror16",      {0x01,0x11}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"ror32",      {0x01,0x12}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"ror64",      {0x01,0x13}, 2, 3, ENC_THREE,     0x00, 0xF0},
+    {"mcpy",       {0x01,0x40}, 2, 3, ENC_THREE,     0x02, 0x00},
+    {"mset",       {0x01,0x41}, 2, 3, ENC_THREE,     0x02, 0x00},
+    {"ins",        {0x01,0x3E}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"outs",       {0x01,0x3F}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vadd8",      {0x02,0x00}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vadd16",     {0x02,0x01}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vadd32",     {0x02,0x02}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vadd64",     {0x02,0x03}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsub8",      {0x02,0x04}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsub16",     {0x02,0x05}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsub32",     {0x02,0x06}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsub64",     {0x02,0x07}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vmul8",      {0x02,0x08}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vmul16",     {0x02,0x09}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vmul32",     {0x02,0x0A}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vmul64",     {0x02,0x0B}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vumin8",     {0x02,0x0C}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vumin16",    {0x02,0x0D}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vumin32",    {0x02,0x0E}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vumin64",    {0x02,0x0F}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vumax8",     {0x02,0x10}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vumax16",    {0x02,0x11}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vumax32",    {0x02,0x12}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vumax64",    {0x02,0x13}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsmin8",     {0x02,0x14}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsmin16",    {0x02,0x15}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsmin32",    {0x02,0x16}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsmin64",    {0x02,0x17}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsmax8",     {0x02,0x18}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsmax16",    {0x02,0x19}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsmax32",    {0x02,0x1A}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vsmax64",    {0x02,0x1B}, 2, 3, ENC_THREE,     0x00, 0x00},
+    {"vcmpeq8",    {0x02,0x1C}, 2, 3, ENC_THREE,     0x00, 0x40},
+    {"vcmpeq16",   {0x02,0x1D}, 2, 3, ENC_THREE,     0x00, 0x40},
+    {"vcmpeq32",   {0x02,0x1E}, 2, 3, ENC_THREE,     0x00, 0x40},
+    {"vcmpeq64",   {0x02,0x1F}, 2, 3, ENC_THREE,     0x00, 0x40},
+    {"vshuf8",     {0x02,0x20}, 2, 3, ENC_THREE,     0x00, 0x00},
+
+    // Four operands
+    {"sclamp8",    {0xD6},      1, 4, ENC_FOUR,      0x00, 0x60},
+    {"uclamp8",    {0xD7},      1, 4, ENC_FOUR,      0x00, 0x40},
+    {"sclamp16",   {0xD8},      1, 4, ENC_FOUR,      0x00, 0x60},
+    {"uclamp16",   {0xD9},      1, 4, ENC_FOUR,      0x00, 0x40},
+    {"sclamp32",   {0xDA},      1, 4, ENC_FOUR,      0x00, 0x60},
+    {"uclamp32",   {0xDB},      1, 4, ENC_FOUR,      0x00, 0x40},
+    {"sclamp64",   {0xDC},      1, 4, ENC_FOUR,      0x00, 0x60},
+    {"uclamp64",   {0xDD},      1, 4, ENC_FOUR,      0x00, 0x40},
+    {"mcmp",       {0x01,0x42}, 2, 4, ENC_FOUR,      0x02, 0xC0},
+    {"mchr",       {0x01,0x43}, 2, 4, ENC_FOUR,      0x02, 0x40},
+};
+
+static constexpr size_t MNEMONIC_COUNT   = std::size(mnemonicTable);
+static constexpr size_t MNEMONIC_BUCKETS = MNEMONIC_COUNT / 2;
+static constexpr size_t MNEMONIC_SLOTS   = 512;
+static constexpr uint16_t MNEMONIC_EMPTY = 0xFFFF;
+
+static_assert(MNEMONIC_SLOTS >= MNEMONIC_COUNT);
+
+constexpr uint32_t mnemonicHash(std::string_view name, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 13;
+    return h;
+}
+
+// Hash and displace: every mnemonic first hashes into a bucket, then each bucket (largest
+// first) gets the smallest seed that moves all of its names into free slots.
+struct MnemonicHashTable {
+    std::array<uint16_t, MNEMONIC_BUCKETS> seeds{};
+    std::array<uint16_t, MNEMONIC_SLOTS> slots{};
+};
+
+constexpr MnemonicHashTable buildMnemonicHashTable() {
+    MnemonicHashTable table;
+    for (auto& slot : table.slots) slot = MNEMONIC_EMPTY;
+
+    std::array<uint16_t, MNEMONIC_BUCKETS> bucketSize{};
+    for (size_t i = 0; i < MNEMONIC_COUNT; i++)
+        bucketSize[mnemonicHash(mnemonicTable[i].name, 0) % MNEMONIC_BUCKETS]++;
+
+    for (int size = MNEMONIC_COUNT; size > 0; size--) {
+        for (size_t bucket = 0; bucket < MNEMONIC_BUCKETS; bucket++) {
+            if (bucketSize[bucket] != size) continue;
+
+            std::array<uint16_t, MNEMONIC_COUNT> members{};
+            size_t count = 0;
+            for (size_t i = 0; i < MNEMONIC_COUNT; i++)
+                if (mnemonicHash(mnemonicTable[i].name, 0) % MNEMONIC_BUCKETS == bucket) members[count++] = i;
+
+            for (uint32_t seed = 1; ; seed++) {
+                if (seed == MNEMONIC_EMPTY) throw "No displacement found for mnemonic bucket";
+
+                std::array<uint16_t, MNEMONIC_COUNT> placed{};
+                bool fits = true;
+                for (size_t m = 0; m < count && fits; m++) {
+                    placed[m] = mnemonicHash(mnemonicTable[members[m]].name, seed) % MNEMONIC_SLOTS;
+                    if (table.slots[placed[m]] != MNEMONIC_EMPTY) fits = false;
+                    for (size_t k = 0; k < m && fits; k++)
+                        if (placed[k] == placed[m]) fits = false;
+                }
+
+                if (!fits) continue;
+
+                for (size_t m = 0; m < count; m++) table.slots[placed[m]] = members[m];
+                table.seeds[bucket] = seed;
+                break;
+            }
+        }
+    }
+
+    return table;
+}
+
+static constexpr MnemonicHashTable mnemonicHashTable = buildMnemonicHashTable();
+
+constexpr const Mnemonic* findMnemonic(std::string_view name) {
+    uint32_t seed = mnemonicHashTable.seeds[mnemonicHash(name, 0) % MNEMONIC_BUCKETS];
+    uint16_t index = mnemonicHashTable.slots[mnemonicHash(name, seed) % MNEMONIC_SLOTS];
+    if (index == MNEMONIC_EMPTY || mnemonicTable[index].name != name) return nullptr;
+    return &mnemonicTable[index];
+}
+
+constexpr bool everyMnemonicFound() {
+    for (const auto& m : mnemonicTable)
+        if (findMnemonic(m.name) != &m) return false;
+    return true;
+}
+
+static_assert(everyMnemonicFound(), "Duplicate mnemonic in mnemonicTable");
+static_assert(!findMnemonic("mval65"));
+
+// flagsLiveAfter drops code whose flags are overwritten later, so a row may only list flags
+// the CPU really writes. Of the vector instructions that is vcmpeq setting ZERO.
+constexpr bool vectorFlagsMatchCpu() {
+    for (const auto& m : mnemonicTable) {
+        if (m.opcodeSize != 2 || m.opcode[0] != 0x02) continue;
+        uint8_t expected = m.name.starts_with("vcmpeq") ? 0x40 : 0x00;
+        if (m.flagsWritten != expected) return false;
+    }
+    return true;
+}
+
+static_assert(vectorFlagsMatchCpu(), "Vector instruction lists flags the CPU does not write");
+
+struct LabelHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
 };
 
-static const std::unordered_map<std::string, uint8_t> general1Operands = {
-    {"inc8",    0x35}, {"inc16",   0x36}, {"inc32",   0x37}, {"inc64",   0x38},
-    {"dec8",    0x39}, {"dec16",   0x3A}, {"dec32",   0x3B}, {"dec64",   0x3C},
-    {"neg8",    0x45}, {"neg16",   0x46}, {"neg32",   0x47}, {"neg64",   0x48},
-    {"abs8",    0x98}, {"abs16",   0x99}, {"abs32",   0x9A}, {"abs64",   0x9B},
-    {"bnot8",   0x61}, {"bnot16",  0x62}, {"bnot32",  0x63}, {"bnot64",  0x64},
-    {"bswap16", 0x85}, {"bswap32", 0x86}, {"bswap64", 0x87},
-    {"push8",   0xB0}, {"push16",  0xB1}, {"push32",  0xB2}, {"push64",  0xB3},
-    {"pop8",    0xB4}, {"pop16",   0xB5}, {"pop32",   0xB6}, {"pop64",   0xB7},
-    {"sleepms", 0xFE}, {"sleepsec",0xFF},
-    {"int",     0xE6},
+struct SourceLocation {
+    const std::string* file = nullptr;
+    size_t line = 0;
 };
 
-static const std::unordered_map<std::string, std::vector<uint8_t>> general2Operands = {
-    {"mval8",  {0x10}}, {"mval16", {0x11}}, {"mval32", {0x12}}, {"mval64", {0x13}},
-    {"scmp8",  {0x49}}, {"ucmp8",  {0x4A}}, {"scmp16", {0x4B}}, {"ucmp16", {0x4C}},
-    {"scmp32", {0x4D}}, {"ucmp32", {0x4E}}, {"scmp64", {0x4F}}, {"ucmp64", {0x50}},
-    {"test8",  {0x51}}, {"test16", {0x52}}, {"test32", {0x53}}, {"test64", {0x54}},
-    {"btst8",  {0x81}}, {"btst16", {0x82}}, {"btst32", {0x83}}, {"btst64", {0x84}},
-    {"loop",   {0xAD}},
-    {"xchg",   {0xC3}},
-    {"sext8",  {0xE0}}, {"sext16", {0xE1}}, {"sext32", {0xE2}},
-    {"zext8",  {0xE3}}, {"zext16", {0xE4}}, {"zext32", {0xE5}},
-    {"in8",    {0xE8}}, {"in16",   {0xE9}}, {"in32",   {0xEA}}, {"in64",   {0xEB}},
-    {"out8",   {0xEC}}, {"out16",  {0xED}}, {"out32",  {0xEE}}, {"out64",  {0xEF}},
-    {"popcnt8", {0x01,0x14}}, {"popcnt16",{0x01,0x15}}, {"popcnt32",{0x01,0x16}}, {"popcnt64",{0x01,0x17}},
-    {"clz8",   {0x01,0x18}}, {"clz16",  {0x01,0x19}}, {"clz32",  {0x01,0x1A}}, {"clz64",  {0x01,0x1B}},
-    {"ctz8",   {0x01,0x1C}}, {"ctz16",  {0x01,0x1D}}, {"ctz32",  {0x01,0x1E}}, {"ctz64",  {0x01,0x1F}},
-    {"bsf8",   {0x01,0x20}}, {"bsf16",  {0x01,0x21}}, {"bsf32",  {0x01,0x22}}, {"bsf64",  {0x01,0x23}},
-    {"bsr8",   {0x01,0x24}}, {"bsr16",  {0x01,0x25}}, {"bsr32",  {0x01,0x26}}, {"bsr64",  {0x01,0x27}},
+struct Macro {
+    std::vector<std::string> parameters;
+    std::vector<std::string> body;
 };
 
-static const std::unordered_map<std::string, std::vector<uint8_t>> general3Operands = {
-    {"sadd8",  {0x15}}, {"uadd8",  {0x16}}, {"sadd16", {0x17}}, {"uadd16", {0x18}},
-    {"sadd32", {0x19}}, {"uadd32", {0x1A}}, {"sadd64", {0x1B}}, {"uadd64", {0x1C}},
-    {"ssub8",  {0x1D}}, {"usub8",  {0x1E}}, {"ssub16", {0x1F}}, {"usub16", {0x20}},
-    {"ssub32", {0x21}}, {"usub32", {0x22}}, {"ssub64", {0x23}}, {"usub64", {0x24}},
-    {"smul8",  {0x25}}, {"umul8",  {0x26}}, {"smul16", {0x27}}, {"umul16", {0x28}},
-    {"smul32", {0x29}}, {"umul32", {0x2A}}, {"smul64", {0x2B}}, {"umul64", {0x2C}},
-    {"sdiv8",  {0x2D}}, {"udiv8",  {0x2E}}, {"sdiv16", {0x2F}}, {"udiv16", {0x30}},
-    {"sdiv32", {0x31}}, {"udiv32", {0x32}}, {"sdiv64", {0x33}}, {"udiv64", {0x34}},
-    {"smod8",  {0x3D}}, {"umod8",  {0x3E}}, {"smod16", {0x3F}}, {"umod16", {0x40}},
-    {"smod32", {0x41}}, {"umod32", {0x42}}, {"smod64", {0x43}}, {"umod64", {0x44}},
-    {"and8",   {0x55}}, {"and16",  {0x56}}, {"and32",  {0x57}}, {"and64",  {0x58}},
-    {"or8",    {0x59}}, {"or16",   {0x5A}}, {"or32",   {0x5B}}, {"or64",   {0x5C}},
-    {"xor8",   {0x5D}}, {"xor16",  {0x5E}}, {"xor32",  {0x5F}}, {"xor64",  {0x60}},
-    {"shl8",   {0x65}}, {"shl16",  {0x66}}, {"shl32",  {0x67}}, {"shl64",  {0x68}},
-    {"shr8",   {0x69}}, {"shr16",  {0x6A}}, {"shr32",  {0x6B}}, {"shr64",  {0x6C}},
-    {"sar8",   {0x6D}}, {"sar16",  {0x6E}}, {"sar32",  {0x6F}}, {"sar64",  {0x70}},
-    {"andn8",  {0x71}}, {"andn16", {0x72}}, {"andn32", {0x73}}, {"andn64", {0x74}},
-    {"bset8",  {0x75}}, {"bset16", {0x76}}, {"bset32", {0x77}}, {"bset64", {0x78}},
-    {"bclr8",  {0x79}}, {"bclr16", {0x7A}}, {"bclr32", {0x7B}}, {"bclr64", {0x7C}},
-    {"bflip8", {0x7D}}, {"bflip16",{0x7E}}, {"bflip32",{0x7F}}, {"bflip64",{0x80}},
-    {"sadc8",  {0x88}}, {"uadc8",  {0x89}}, {"sadc16", {0x8A}}, {"uadc16", {0x8B}},
-    {"sadc32", {0x8C}}, {"uadc32", {0x8D}}, {"sadc64", {0x8E}}, {"uadc64", {0x8F}},
-    {"ssbc8",  {0x90}}, {"usbc8",  {0x91}}, {"ssbc16", {0x92}}, {"usbc16", {0x93}},
-    {"ssbc32", {0x94}}, {"usbc32", {0x95}}, {"ssbc64", {0x96}}, {"usbc64", {0x97}},
-    {"smulhi64",{0xC4}},{"umulhi64",{0xC5}},
-    {"smin8",  {0xC6}}, {"umin8",  {0xC7}}, {"smax8",  {0xC8}}, {"umax8",  {0xC9}},
-    {"smin16", {0xCA}}, {"umin16", {0xCB}}, {"smax16", {0xCC}}, {"umax16", {0xCD}},
-    {"smin32", {0xCE}}, {"umin32", {0xCF}}, {"smax32", {0xD0}}, {"umax32", {0xD1}},
-    {"smin64", {0xD2}}, {"umin64", {0xD3}}, {"smax64", {0xD4}}, {"umax64", {0xD5}},
-    {"nand8",  {0x01,0x00}}, {"nand16",{0x01,0x01}}, {"nand32",{0x01,0x02}}, {"nand64",{0x01,0x03}},
-    {"nor8",   {0x01,0x04}}, {"nor16", {0x01,0x05}}, {"nor32", {0x01,0x06}}, {"nor64", {0x01,0x07}},
-    {"xnor8",  {0x01,0x08}}, {"xnor16",{0x01,0x09}}, {"xnor32",{0x01,0x0A}}, {"xnor64",{0x01,0x0B}},
-    {"rol8",   {0x01,0x0C}}, {"rol16", {0x01,0x0D}}, {"rol32", {0x01,0x0E}}, {"rol64", {0x01,0x0F}},
-    {"ror8",   {0x01,0x10}}, {"ror16", {0x01,0x11}}, {"ror32", {0x01,0x12}}, {"ror64", {0x01,0x13}},
+struct PeepholeRewrite {
+    SourceLocation location;
+    std::string before;
+    std::string after;      // empty when the instruction was dropped
 };
 
-static const std::unordered_map<std::string, uint8_t> general4Operands = {
-    {"sclamp8",  0xD6}, {"uclamp8",  0xD7},
-    {"sclamp16", 0xD8}, {"uclamp16", 0xD9},
-    {"sclamp32", 0xDA}, {"uclamp32", 0xDB},
-    {"sclamp64", 0xDC}, {"uclamp64", 0xDD},
+struct LabelReference {
+    uint64_t offset;
+    uint8_t size;
+    std::string name;
 };
 
 struct Assembler {
     std::vector<uint8_t> output;
-    std::vector<Label> labels;
+    std::unordered_map<std::string, uint64_t, LabelHash, std::equal_to<>> labels;
+    std::vector<std::string> includePaths;
+
+    std::unordered_map<std::string, std::string, LabelHash, std::equal_to<>> defines;   // .equ and .define
+    std::unordered_map<std::string, Macro, LabelHash, std::equal_to<>> macros;
+    Macro* recording = nullptr;
+    uint64_t macroExpansions = 0;
+
+    std::unordered_set<std::string> sourceFiles;
+    SourceLocation location;    // of the line being handed out, macro lines keep the call site
+
+    bool objectMode = false;
+    std::vector<LabelReference> labelReferences;
+
+    bool optimizeSize = false;
+    std::vector<uint8_t> labelWidths;
+    size_t labelCursor = 0;
+    uint64_t savedBytes = 0;
+    uint64_t alignment = 1;     // largest .align, kept with the object so -c output stays aligned
+
+    bool peephole = false;
+    std::string preparedFile;
+    std::vector<std::string> preparedLines;
+    std::vector<SourceLocation> preparedLocations;
+    std::vector<PeepholeRewrite> rewrites;
 
     std::string trim(const std::string& s);
-    std::vector<std::string> split(const std::string& s);
-    std::vector<std::string> readFile(const std::string& filename);
-    void secondPass(const std::vector<std::string>& lines);
+    void split(std::string_view s, std::vector<std::string_view>& out);
+    std::string resolveInclude(const std::string& name, const std::string& fromFile);
+    void readFile(const std::string& filename, const std::function<void(const std::string&)>& handle, int depth = 0);
+    void preprocessLine(const std::string& line, const std::function<void(const std::string&)>& handle, int depth);
+    size_t lineSize(const std::vector<std::string_view>& tokens, uint64_t address);
+    size_t directiveSize(const std::vector<std::string_view>& tokens, uint64_t address);
+    void emitDirective(const std::vector<std::string_view>& tokens, uint8_t*& out);
+    void forEachLine(const std::string& filename, const std::function<void(const std::string&)>& handle);
+    void peepholePass(const std::string& filename);
+    bool peepholeRewrite(const std::vector<std::vector<std::string_view>>& program, size_t index, std::string& replacement);
+    bool flagsLiveAfter(const std::vector<std::vector<std::string_view>>& program, size_t index, uint8_t mask);
+    void firstPass(const std::string& filename);
+    void secondPass(const std::string& filename);
+    void parallelAssemble(const std::string& filename, int jobs);
+    void emitLine(const std::vector<std::string_view>& tokens, uint8_t*& out);
     void writeOutput(const std::string& filename);
+    void writeListing(const std::string& filename, const std::string& listingFile);
+    void writeMap(const std::string& mapFile);
+    ObjectFile makeObject();
+    void writeObject(const std::string& filename);
+    uint64_t sourceHash(const std::string& filename, const std::string& options);
     void error(const std::string& type, const std::string& info) const;
-    std::vector<std::string> parseDescriptor(const std::string& desc);
-    std::vector<uint8_t> autoSizeBytes(const std::string& valueToken);
+    std::vector<uint8_t> autoSizeBytes(std::string_view valueToken);
 
-    uint8_t descriptorByte(const std::string& type);
-    int operandSize(const std::string& type);
-    void encodeOperand(const std::string& type, const std::string& valueToken);
+    uint8_t descriptorByte(std::string_view type);
+    int operandSize(std::string_view type);
+    uint64_t parseNumber(std::string_view token);
+    uint64_t operandValue(std::string_view valueToken);
+    void encodeOperand(std::string_view type, std::string_view valueToken, uint8_t*& out);
+    void encodeValue(std::string_view valueToken, int size, uint8_t*& out);
+    int encodedSize(std::string_view type, std::string_view valueToken);
 };
 
 extern Assembler assembler;
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <bit>
+
+// TrASM object file (.tro), written by `assembler -c` and read by the linker.
+//
+//   "TRO2"
+//   u32 section count,    per section:    u16 name length, name, u64 size, u64 alignment, bytes
+//   u32 symbol count,     per symbol:     u16 name length, name, u32 section, u64 offset
+//   u32 relocation count, per relocation: u32 section, u64 offset, u8 size, u32 symbol
+//
+// All numbers are little endian. A symbol with section OBJECT_UNDEFINED is imported from
+// another object. A relocation adds the final address of its symbol to the size bytes at
+// offset, which hold the addend (0 for a plain !label). alignment is the largest .align in
+// the section (a power of two, 1 without any); the linker starts the section on it.
+
+static constexpr char     OBJECT_MAGIC[4]  = {'T', 'R', 'O', '2'};
+static constexpr uint32_t OBJECT_UNDEFINED = 0xFFFFFFFF;
+
+struct ObjectSection {
+    std::string name;
+    std::vector<uint8_t> bytes;
+    uint64_t alignment = 1;
+};
+
+struct ObjectSymbol {
+    std::string name;
+    uint32_t section;
+    uint64_t offset;
+};
+
+struct ObjectRelocation {
+    uint32_t section;
+    uint64_t offset;
+    uint8_t  size;
+    uint32_t symbol;
+};
+
+struct ObjectFile {
+    std::vector<ObjectSection>    sections;
+    std::vector<ObjectSymbol>     symbols;
+    std::vector<ObjectRelocation> relocations;
+};
+
+namespace objectIO {
+    template <typename T>
+    inline void put(std::ostream& f, T value) {
+        for (size_t i = 0; i < sizeof(T); i++) f.put(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+
+    template <typename T>
+    inline bool get(std::istream& f, T& value) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            int c = f.get();
+            if (c == EOF) return false;
+            v |= static_cast<uint64_t>(static_cast<uint8_t>(c)) << (8 * i);
+        }
+        value = static_cast<T>(v);
+        return true;
+    }
+
+    inline void putName(std::ostream& f, const std::string& name) {
+        put<uint16_t>(f, name.size());
+        f.write(name.data(), name.size());
+    }
+
+    inline bool getName(std::istream& f, std::string& name) {
+        uint16_t size;
+        if (!get(f, size)) return false;
+        name.resize(size);
+        return static_cast<bool>(f.read(name.data(), size));
+    }
+}
+
+inline bool writeObjectFile(const std::string& filename, const ObjectFile& object) {
+    using namespace objectIO;
+
+    std::ofstream f(filename, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+
+    f.write(OBJECT_MAGIC, 4);
+
+    put<uint32_t>(f, object.sections.size());
+    for (const auto& s : object.sections) {
+        putName(f, s.name);
+        put<uint64_t>(f, s.bytes.size());
+        put<uint64_t>(f, s.alignment);
+        f.write(reinterpret_cast<const char*>(s.bytes.data()), s.bytes.size());
+    }
+
+    put<uint32_t>(f, object.symbols.size());
+    for (const auto& s : object.symbols) {
+        putName(f, s.name);
+        put<uint32_t>(f, s.section);
+        put<uint64_t>(f, s.offset);
+    }
+
+    put<uint32_t>(f, object.relocations.size());
+    for (const auto& r : object.relocations) {
+        put<uint32_t>(f, r.section);
+        put<uint64_t>(f, r.offset);
+        put<uint8_t>(f, r.size);
+        put<uint32_t>(f, r.symbol);
+    }
+
+    return static_cast<bool>(f);
+}
+
+// Returns false when the file cannot be read or is not a valid object.
+inline bool readObjectFile(const std::string& filename, ObjectFile& object) {
+    using namespace objectIO;
+
+    std::ifstream f(filename, std::ios::binary);
+    if (!f) return false;
+
+    char magic[4];
+    if (!f.read(magic, 4) || std::string(magic, 4) != std::string(OBJECT_MAGIC, 4)) return false;
+
+    object = {};
+    uint32_t count;
+
+    if (!get(f, count)) return false;
+    object.sections.resize(count);
+    for (auto& s : object.sections) {
+        uint64_t size;
+        if (!getName(f, s.name) || !get(f, size) || !get(f, s.alignment)) return false;
+        if (!std::has_single_bit(s.alignment)) return false;
+        s.bytes.resize(size);
+        if (!f.read(reinterpret_cast<char*>(s.bytes.data()), size)) return false;
+    }
+
+    if (!get(f, count)) return false;
+    object.symbols.resize(count);
+    for (auto& s : object.symbols) {
+        if (!getName(f, s.name) || !get(f, s.section) || !get(f, s.offset)) return false;
+        if (s.section != OBJECT_UNDEFINED && s.section >= object.sections.size()) return false;
+    }
+
+    if (!get(f, count)) return false;
+    object.relocations.resize(count);
+    for (auto& r : object.relocations) {
+        if (!get(f, r.section) || !get(f, r.offset) || !get(f, r.size) || !get(f, r.symbol)) return false;
+        if (r.section >= object.sections.size() || r.symbol >= object.symbols.size()) return false;
+        if (r.size > 8 || r.offset + r.size > object.sections[r.section].bytes.size()) return false;
+    }
+
+    return true;
+}
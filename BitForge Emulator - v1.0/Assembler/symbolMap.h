@@ -0,0 +1,85 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+// Symbol map (.map), written by `assembler --map` and `linker --map` for the tools that
+// symbolise addresses. One label per line, sorted by address:
+//
+//   0x0000000000000040 24 label_name
+//
+// address in hex, size in bytes up to the next label (or the end of the code), then the name.
+// Lines starting with ';' are comments.
+
+struct MapSymbol {
+    std::string name;
+    uint64_t address;
+    uint64_t size;
+};
+
+template <typename Labels>
+inline std::vector<MapSymbol> buildSymbolMap(const Labels& labels, uint64_t end) {
+    std::vector<MapSymbol> symbols;
+    for (const auto& [name, address] : labels) symbols.push_back({name, address, 0});
+
+    std::sort(symbols.begin(), symbols.end(), [](const MapSymbol& a, const MapSymbol& b) {
+        return a.address != b.address ? a.address < b.address : a.name < b.name;
+    });
+
+    for (size_t i = 0; i < symbols.size(); i++) {
+        uint64_t next = i + 1 < symbols.size() ? symbols[i + 1].address : end;
+        symbols[i].size = next > symbols[i].address ? next - symbols[i].address : 0;
+    }
+
+    return symbols;
+}
+
+inline bool writeSymbolMap(const std::string& filename, const std::vector<MapSymbol>& symbols) {
+    std::ofstream f(filename, std::ios::trunc);
+    if (!f) return false;
+
+    f << "; address size label\n";
+    char address[24];
+    for (const auto& s : symbols) {
+        std::snprintf(address, sizeof(address), "0x%016llx", static_cast<unsigned long long>(s.address));
+        f << address << " " << s.size << " " << s.name << "\n";
+    }
+
+    return static_cast<bool>(f);
+}
+
+// Returns false when the file cannot be read or a line is malformed.
+inline bool readSymbolMap(const std::string& filename, std::vector<MapSymbol>& symbols) {
+    std::ifstream f(filename);
+    if (!f) return false;
+
+    symbols.clear();
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.empty() || line[0] == ';' || line == "\r") continue;
+
+        std::istringstream fields(line);
+        std::string address;
+        MapSymbol s;
+        if (!(fields >> address >> s.size >> s.name)) return false;
+        char* end;
+        s.address = std::strtoull(address.c_str(), &end, 0);
+        if (*end != '\0') return false;
+        symbols.push_back(s);
+    }
+
+    return true;
+}
+
+// Symbol whose range holds address, nullptr when none does. symbols must be sorted.
+inline const MapSymbol* findSymbol(const std::vector<MapSymbol>& symbols, uint64_t address) {
+    auto it = std::upper_bound(symbols.begin(), symbols.end(), address, [](uint64_t a, const MapSymbol& s) { return a < s.address; });
+    if (it == symbols.begin()) return nullptr;
+    --it;
+    return address < it->address + std::max<uint64_t>(it->size, 1) ? &*it : nullptr;
+}
@@ -0,0 +1,119 @@
+#include "linker.h"
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+
+void Linker::error(const std::string& type, const std::string& info) {
+    if (testing) {
+        testingError = type;
+        return;
+    }
+
+    std::cerr << "ERROR [" << type << "]";
+    if (!info.empty()) std::cerr << " - " << info;
+    std::cerr << "\nStopping...\n";
+    exit(1);
+}
+
+void Linker::load(const std::string& filename) {
+    ObjectFile object;
+    if (!readObjectFile(filename, object)) {
+        error("LNK00001", filename);
+        return;
+    }
+
+    add(filename, std::move(object));
+}
+
+void Linker::add(const std::string& name, ObjectFile object) {
+    inputNames.push_back(name);
+    objects.push_back(std::move(object));
+}
+
+// Sections with the same name are placed together, in the order the names first appear,
+// each object contributing in command line order. A section starts on its alignment, the
+// gap before it is filled with 0x00 like .align padding.
+void Linker::layout() {
+    std::vector<std::string> order;
+    for (const auto& object : objects)
+        for (const auto& section : object.sections)
+            if (std::find(order.begin(), order.end(), section.name) == order.end())
+                order.push_back(section.name);
+
+    sectionAddress.assign(objects.size(), {});
+    for (size_t o = 0; o < objects.size(); o++)
+        sectionAddress[o].assign(objects[o].sections.size(), 0);
+
+    image.clear();
+    for (const auto& name : order) {
+        for (size_t o = 0; o < objects.size(); o++) {
+            for (size_t s = 0; s < objects[o].sections.size(); s++) {
+                const auto& section = objects[o].sections[s];
+                if (section.name != name) continue;
+
+                uint64_t address = (base + image.size() + section.alignment - 1) & ~(section.alignment - 1);
+                image.resize(address - base, 0x00);
+
+                sectionAddress[o][s] = address;
+                image.insert(image.end(), section.bytes.begin(), section.bytes.end());
+            }
+        }
+    }
+}
+
+void Linker::resolveSymbols() {
+    symbols.clear();
+
+    for (size_t o = 0; o < objects.size(); o++) {
+        for (const auto& symbol : objects[o].symbols) {
+            if (symbol.section == OBJECT_UNDEFINED) continue;
+
+            uint64_t address = sectionAddress[o][symbol.section] + symbol.offset;
+            if (!symbols.emplace(symbol.name, address).second)
+                error("LNK00002", symbol.name + " in " + inputNames[o]);
+        }
+    }
+}
+
+void Linker::applyRelocations() {
+    for (size_t o = 0; o < objects.size(); o++) {
+        const auto& object = objects[o];
+
+        for (const auto& r : object.relocations) {
+            const auto& symbol = object.symbols[r.symbol];
+            auto it = symbols.find(symbol.name);
+            if (it == symbols.end()) {
+                error("LNK00003", symbol.name + " in " + inputNames[o]);
+                continue;
+            }
+
+            uint8_t* field = image.data() + (sectionAddress[o][r.section] - base) + r.offset;
+
+            uint64_t addend = 0;
+            for (int i = 0; i < r.size; i++) addend |= static_cast<uint64_t>(field[i]) << (8 * i);
+
+            uint64_t value = it->second + addend;
+            if (r.size < 8 && (value >> (8 * r.size)) != 0) {
+                error("LNK00004", symbol.name + " (" + std::to_string(value) + ") in " + inputNames[o]);
+                continue;
+            }
+
+            for (int i = 0; i < r.size; i++) field[i] = (value >> (8 * i)) & 0xFF;
+        }
+    }
+}
+
+void Linker::link() {
+    layout();
+    resolveSymbols();
+    applyRelocations();
+}
+
+void Linker::writeImage(const std::string& filename) {
+    std::ofstream f(filename, std::ios::binary | std::ios::trunc);
+    if (!f) {
+        error("LNK00006", filename);
+        return;
+    }
+    f.write(reinterpret_cast<const char*>(image.data()), image.size());
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "../Assembler/objectFile.h"
+
+static constexpr uint64_t LINK_ROM_BASE = 0x0000;
+static constexpr uint64_t LINK_ROM_SIZE = 32 * 1024;
+static constexpr uint64_t LINK_RAM_BASE = 0x8000;
+
+struct Linker {
+    std::vector<std::string> inputNames;
+    std::vector<ObjectFile> objects;
+    std::vector<std::vector<uint64_t>> sectionAddress;
+    std::unordered_map<std::string, uint64_t> symbols;
+    std::vector<uint8_t> image;
+    uint64_t base = LINK_ROM_BASE;
+
+    // With testing set, error() records its type here instead of stopping the process and
+    // the step that failed skips the bad symbol or relocation.
+    bool testing = false;
+    std::string testingError;
+
+    void load(const std::string& filename);
+    void add(const std::string& name, ObjectFile object);
+    void layout();
+    void resolveSymbols();
+    void applyRelocations();
+    void link();
+    void writeImage(const std::string& filename);
+    void error(const std::string& type, const std::string& info);
+};
+
+extern Linker linker;
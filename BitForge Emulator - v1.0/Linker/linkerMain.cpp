@@ -0,0 +1,74 @@
+#include "linker.h"
+#include "../Assembler/symbolMap.h"
+#include <iostream>
+
+Linker linker;
+
+static void printUsage() {
+    std::cerr << "Usage: linker <a.tro> [b.tro]... [-o output.bin] [--ram] [--base address] [--no-pad] [--map file]\n"
+              << "  -o <file>        Output file (default rom.bin)\n"
+              << "  --ram            Link a RAM image at 0x8000 instead of a ROM image at 0x0000\n"
+              << "  --base <addr>    Link at this address instead\n"
+              << "  --no-pad         Do not pad a ROM image to 32KB\n"
+              << "  --map <file>     Write the symbol map (address, size, name) to file\n"
+              << "Exit codes: 0 done, 1 link error, 2 bad arguments.\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    std::string outputFile = "rom.bin";
+    std::string mapFile;
+    bool ram = false;
+    bool pad = true;
+    bool baseGiven = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        }
+
+        else if (arg == "-o" && i + 1 < argc) outputFile = argv[++i];
+        else if (arg == "--ram") ram = true;
+        else if (arg == "--no-pad") pad = false;
+        else if (arg == "--map" && i + 1 < argc) mapFile = argv[++i];
+        else if (arg == "--base" && i + 1 < argc) {
+            linker.base = std::stoull(argv[++i], nullptr, 0);
+            baseGiven = true;
+        }
+
+        else if (arg[0] != '-') inputs.push_back(arg);
+
+        else {
+            std::cerr << "Unexpected argument: " << arg << "\n";
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (inputs.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    if (!baseGiven) linker.base = ram ? LINK_RAM_BASE : LINK_ROM_BASE;
+
+    for (const auto& input : inputs) linker.load(input);
+
+    linker.link();
+
+    if (!mapFile.empty() && !writeSymbolMap(mapFile, buildSymbolMap(linker.symbols, linker.base + linker.image.size())))
+        linker.error("LNK00006", mapFile);
+
+    if (!ram) {
+        if (linker.base + linker.image.size() > LINK_ROM_SIZE)
+            linker.error("LNK00005", std::to_string(linker.base + linker.image.size()) + " bytes");
+        if (pad) linker.image.resize(LINK_ROM_SIZE - linker.base, 0x00);
+    }
+
+    linker.writeImage(outputFile);
+    std::cout << "Done! " << linker.image.size() << " bytes linked into " << outputFile << "\n";
+    return 0;
+}
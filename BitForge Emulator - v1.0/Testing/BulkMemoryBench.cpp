@@ -0,0 +1,142 @@
+// Microbenchmark for the bulk memory instructions (mcpy/mset).
+// Runs the same 1MB fill and copy once as a TrASM loop of mval64 and once as a single bulk
+// instruction, straight through fetch/decode/execute, and prints time and throughput.
+// Writes benchRom.bin next to the executable.
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include "../motherboard.h"
+#include "../cpu.h"
+#include "../timer.h"
+
+using namespace std;
+
+static constexpr uint64_t BLOCK_BYTES = 1024 * 1024;
+static constexpr uint64_t BLOCK_A     = Motherboard::RAM_START;
+static constexpr uint64_t BLOCK_B     = Motherboard::RAM_START + BLOCK_BYTES;
+
+struct Program {
+    vector<uint8_t> bytes;
+
+    void op(initializer_list<uint8_t> b) { bytes.insert(bytes.end(), b); }
+    void u8(uint8_t v) { bytes.push_back(v); }
+    void u64(uint64_t v) { for (int i = 0; i < 8; i++) bytes.push_back((v >> (8 * i)) & 0xFF); }
+};
+
+// mval64 r8<i64< reg value
+void mvalRegImm(Program& p, uint8_t reg, uint64_t value) {
+    p.op({0x13, 0x00, 0x04}); p.u8(reg); p.u64(value);
+}
+
+// uadd64 r8<r8<i8< reg reg amount
+void addRegImm(Program& p, uint8_t reg, uint8_t amount) {
+    p.op({0x1C, 0x00, 0x00, 0x01}); p.u8(reg); p.u8(reg); p.u8(amount);
+}
+
+// loop i8<i64< counterReg address
+void loopTo(Program& p, uint8_t counterReg, uint64_t address) {
+    p.op({0xAD, 0x01, 0x04}); p.u8(counterReg); p.u64(address);
+}
+
+Program memsetLoop() {
+    Program p;
+    mvalRegImm(p, 1, BLOCK_A);
+    mvalRegImm(p, 2, BLOCK_BYTES / 8);
+    uint64_t top = p.bytes.size();
+    p.op({0x13, 0x09, 0x04}); p.u8(1); p.u64(0xABABABABABABABABull);   // mval64 mr8<i64< 1 value
+    addRegImm(p, 1, 8);
+    loopTo(p, 2, top);
+    p.u8(0xFD);
+    return p;
+}
+
+Program memsetBulk() {
+    Program p;
+    p.op({0x01, 0x41, 0x04, 0x01, 0x04}); p.u64(BLOCK_A); p.u8(0xAB); p.u64(BLOCK_BYTES);   // mset i64<i8<i64<
+    p.u8(0xFD);
+    return p;
+}
+
+Program memcpyLoop() {
+    Program p;
+    mvalRegImm(p, 1, BLOCK_B);
+    mvalRegImm(p, 3, BLOCK_A);
+    mvalRegImm(p, 2, BLOCK_BYTES / 8);
+    uint64_t top = p.bytes.size();
+    p.op({0x13, 0x09, 0x09}); p.u8(1); p.u8(3);   // mval64 mr8<mr8< 1 3
+    addRegImm(p, 1, 8);
+    addRegImm(p, 3, 8);
+    loopTo(p, 2, top);
+    p.u8(0xFD);
+    return p;
+}
+
+Program memcpyBulk() {
+    Program p;
+    p.op({0x01, 0x40, 0x04, 0x04, 0x04}); p.u64(BLOCK_B); p.u64(BLOCK_A); p.u64(BLOCK_BYTES);   // mcpy i64<i64<i64<
+    p.u8(0xFD);
+    return p;
+}
+
+double run(const string& name, const Program& program, int repeats) {
+    vector<uint8_t> image = program.bytes;
+    image.resize(Motherboard::ROM_SIZE, 0x00);
+
+    ofstream f("benchRom.bin", ios::binary | ios::trunc);
+    f.write(reinterpret_cast<const char*>(image.data()), image.size());
+    f.close();
+    rom.loadFromFile("benchRom.bin");
+
+    CPU cpu;
+    cpu.rom = &rom;
+    cpu.memory = &memory;
+
+    uint64_t instructions = 0;
+    Timer timer;
+    timer.start();
+
+    for (int r = 0; r < repeats; r++) {
+        cpu.instructionPointer = Motherboard::ROM_START;
+        cpu.running = true;
+        while (cpu.running) {
+            cpu.fetch();
+            cpu.decode();
+            cpu.execute();
+            instructions++;
+        }
+    }
+
+    double seconds = timer.end() / repeats;
+    double mbps = (BLOCK_BYTES / (1024.0 * 1024.0)) / seconds;
+
+    cout << left << setw(14) << name
+         << right << setw(12) << instructions / repeats << " instr"
+         << setw(14) << fixed << setprecision(6) << seconds << " s"
+         << setw(12) << setprecision(1) << mbps << " MB/s\n";
+
+    return seconds;
+}
+
+int main() {
+    const int repeats = 20;
+
+    cout << "Block size: " << BLOCK_BYTES << " bytes, " << repeats << " runs each\n\n";
+
+    double setLoop = run("memset loop", memsetLoop(), repeats);
+    double setBulk = run("mset", memsetBulk(), repeats);
+    double cpyLoop = run("memcpy loop", memcpyLoop(), repeats);
+    double cpyBulk = run("mcpy", memcpyBulk(), repeats);
+
+    cout << "\nmset speedup: " << setprecision(1) << setLoop / setBulk << "x\n";
+    cout << "mcpy speedup: " << setprecision(1) << cpyLoop / cpyBulk << "x\n";
+
+    if (memory.memory[BLOCK_BYTES - 1] != 0xAB || memory.memory[2 * BLOCK_BYTES - 1] != 0xAB) {
+        cerr << "FAIL: block contents do not match\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+// Throughput benchmark for the channel device (channelController.h).
+// Streams data host -> guest through the input ring and guest -> host through the output ring
+// while the CPU runs a polling loop that moves its own index, and prints MB/s for a few ring
+// sizes. The guest does not touch the data, so this measures the channel itself: one host
+// memcpy per byte plus the head/tail handshake over the ports.
+// Writes rom.bin next to the executable (the motherboard loads it).
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <thread>
+#include <memory>
+#include "../motherboard.h"
+#include "../cpu.h"
+#include "../channelController.h"
+#include "../timer.h"
+
+using namespace std;
+
+static constexpr uint64_t STREAM_BYTES = 256ull * 1024 * 1024;
+static constexpr uint64_t SOURCE_BYTES = 1024 * 1024;
+static constexpr uint64_t RING_ADDRESS = Motherboard::RAM_START;
+
+static constexpr uint16_t INPUT_BASE  = Motherboard::CHANNEL_PORT_START + CHANNEL_RING_INPUT  * CHANNEL_RING_STRIDE;
+static constexpr uint16_t OUTPUT_BASE = Motherboard::CHANNEL_PORT_START + CHANNEL_RING_OUTPUT * CHANNEL_RING_STRIDE;
+
+struct Program {
+    vector<uint8_t> bytes;
+
+    void op(initializer_list<uint8_t> b) { bytes.insert(bytes.end(), b); }
+    void u8(uint8_t v) { bytes.push_back(v); }
+    void u16(uint16_t v) { for (int i = 0; i < 2; i++) bytes.push_back((v >> (8 * i)) & 0xFF); }
+    void u32(uint32_t v) { for (int i = 0; i < 4; i++) bytes.push_back((v >> (8 * i)) & 0xFF); }
+    void u64(uint64_t v) { for (int i = 0; i < 8; i++) bytes.push_back((v >> (8 * i)) & 0xFF); }
+};
+
+// out64 i16<i64< port value / out32 i16<i32< / out8 i16<i8<
+void outImm64(Program& p, uint16_t port, uint64_t value) { p.op({0xEF, 0x02, 0x04}); p.u16(port); p.u64(value); }
+void outImm32(Program& p, uint16_t port, uint32_t value) { p.op({0xEE, 0x02, 0x03}); p.u16(port); p.u32(value); }
+void outImm8 (Program& p, uint16_t port, uint8_t value)  { p.op({0xEC, 0x02, 0x01}); p.u16(port); p.u8(value); }
+
+// in64 r8<i16< reg port / out64 i16<r8< port reg
+void inReg64 (Program& p, uint8_t reg, uint16_t port) { p.op({0xEB, 0x00, 0x02}); p.u8(reg); p.u16(port); }
+void outReg64(Program& p, uint16_t port, uint8_t reg) { p.op({0xEF, 0x02, 0x00}); p.u16(port); p.u8(reg); }
+
+// ucmp64 r8<i64< reg value, then jb i64< address
+void loopWhileBelow(Program& p, uint8_t reg, uint64_t value, uint64_t address) {
+    p.op({0x50, 0x00, 0x04}); p.u8(reg); p.u64(value);
+    p.op({0xA3, 0x04}); p.u64(address);
+}
+
+void enableRing(Program& p, uint16_t base, uint32_t ringBytes) {
+    outImm64(p, base + CHANNEL_REG_ADDRESS, RING_ADDRESS);
+    outImm32(p, base + CHANNEL_REG_SIZE, ringBytes);
+    outImm8 (p, base + CHANNEL_REG_CONTROL, CHANNEL_CONTROL_ENABLE);
+}
+
+// Consumes whatever the host produced: tail = head, until the whole stream went through.
+Program inputConsumer(uint32_t ringBytes) {
+    Program p;
+    enableRing(p, INPUT_BASE, ringBytes);
+    uint64_t top = p.bytes.size();
+    inReg64(p, 1, INPUT_BASE + CHANNEL_REG_HEAD);
+    outReg64(p, INPUT_BASE + CHANNEL_REG_TAIL, 1);
+    loopWhileBelow(p, 1, STREAM_BYTES, top);
+    p.u8(0xFD);
+    return p;
+}
+
+// Fills whatever the host freed: head = tail + ring size.
+Program outputProducer(uint32_t ringBytes) {
+    Program p;
+    enableRing(p, OUTPUT_BASE, ringBytes);
+    uint64_t top = p.bytes.size();
+    inReg64(p, 1, OUTPUT_BASE + CHANNEL_REG_TAIL);
+    p.op({0x1C, 0x00, 0x00, 0x04}); p.u8(2); p.u8(1); p.u64(ringBytes);   // uadd64 r8<r8<i64< 2 1 size
+    outReg64(p, OUTPUT_BASE + CHANNEL_REG_HEAD, 2);
+    loopWhileBelow(p, 2, STREAM_BYTES, top);
+    p.u8(0xFD);
+    return p;
+}
+
+// Byte n of every stream. SOURCE_BYTES is a multiple of 256, so the source buffer repeats it.
+uint8_t pattern(uint64_t position) { return static_cast<uint8_t>(position * 7 + 3); }
+
+vector<uint8_t> source(SOURCE_BYTES);
+
+unique_ptr<Motherboard> boot(const Program& program) {
+    vector<uint8_t> image = program.bytes;
+    image.resize(Motherboard::ROM_SIZE, 0x00);
+
+    ofstream f("rom.bin", ios::binary | ios::trunc);
+    f.write(reinterpret_cast<const char*>(image.data()), image.size());
+    f.close();
+
+    auto board = make_unique<Motherboard>();
+    board->cpu->running = true;
+    return board;
+}
+
+void runCPU(CPU& cpu) {
+    while (cpu.running) {
+        cpu.fetch();
+        cpu.decode();
+        cpu.execute();
+    }
+}
+
+double report(const string& name, uint32_t ringBytes, double seconds) {
+    double mbps = (STREAM_BYTES / (1024.0 * 1024.0)) / seconds;
+    cout << left << setw(14) << name
+         << right << setw(8) << ringBytes / 1024 << " KB ring"
+         << setw(14) << fixed << setprecision(6) << seconds << " s"
+         << setw(12) << setprecision(1) << mbps << " MB/s\n";
+    return mbps;
+}
+
+bool hostToGuest(uint32_t ringBytes) {
+    auto board = boot(inputConsumer(ringBytes));
+    ChannelController& channel = *board->channelController;
+
+    Timer timer;
+    timer.start();
+
+    thread host([&] {
+        uint64_t pushed = 0;
+        while (pushed < STREAM_BYTES) {
+            uint64_t offset = pushed % SOURCE_BYTES;
+            size_t n = channel.push(source.data() + offset, min(SOURCE_BYTES - offset, STREAM_BYTES - pushed));
+            if (n == 0) this_thread::yield();
+            pushed += n;
+        }
+    });
+
+    runCPU(*board->cpu);
+    host.join();
+    report("host -> guest", ringBytes, timer.end());
+
+    // The ring holds the last ringBytes of the stream.
+    for (uint64_t position = STREAM_BYTES - ringBytes; position < STREAM_BYTES; position++)
+        if (memory.memory[position & (ringBytes - 1)] != pattern(position)) return false;
+    return true;
+}
+
+bool guestToHost(uint32_t ringBytes) {
+    auto board = boot(outputProducer(ringBytes));
+    ChannelController& channel = *board->channelController;
+
+    // What the guest "produces" is whatever sits in the ring, so fill it with a known pattern.
+    for (uint64_t i = 0; i < ringBytes; i++) memory.memory[i] = pattern(i);
+
+    vector<uint8_t> sink(SOURCE_BYTES);
+    bool matched = true;
+
+    Timer timer;
+    timer.start();
+
+    thread host([&] {
+        uint64_t pulled = 0;
+        while (pulled < STREAM_BYTES) {
+            size_t n = channel.pull(sink.data(), min<uint64_t>(sink.size(), STREAM_BYTES - pulled));
+            if (n == 0) this_thread::yield();
+            if (n && sink[n - 1] != pattern((pulled + n - 1) % ringBytes)) matched = false;
+            pulled += n;
+        }
+    });
+
+    runCPU(*board->cpu);
+    host.join();
+    report("guest -> host", ringBytes, timer.end());
+    return matched;
+}
+
+int main() {
+    for (uint64_t i = 0; i < SOURCE_BYTES; i++) source[i] = pattern(i);
+
+    cout << "Stream: " << STREAM_BYTES / (1024 * 1024) << " MB each way\n\n";
+
+    bool ok = true;
+    for (uint32_t ringBytes : {64u * 1024, 1024u * 1024, 16u * 1024 * 1024}) {
+        ok &= hostToGuest(ringBytes);
+        ok &= guestToHost(ringBytes);
+    }
+
+    if (!ok) {
+        cerr << "FAIL: ring contents do not match the stream\n";
+        return 1;
+    }
+
+    return 0;
+}
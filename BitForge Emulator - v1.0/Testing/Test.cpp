@@ -16,8 +16,15 @@
 #include "../rom.h"
 #include "../motherboard.h"
 #include "../cpu.h"
+#include "../Assembler/assembler.h"
+#include "../vectorUnit.h"
+#include "../bulkMemory.h"
+#include "../interruptController.h"
+#include "../uartController.h"
+#include "../Linker/linker.h"
 
 #define testFailed(outputFile, tests) testFailedImpl(outputFile, tests, __FILE__, __LINE__)
+#define checkResult(outputFile, tests, ...) checkResultImpl(outputFile, tests, __FILE__, __LINE__, __VA_ARGS__)
 
 using namespace std;
 
@@ -43,6 +50,15 @@ inline std::string hex2(uint8_t v) {
     return b;
 }
 
+// One little endian lane of a vector register as 0x... with 2 digits per byte.
+inline std::string hexLane(const uint8_t* lane, int bytes) {
+    uint64_t v = 0;
+    std::memcpy(&v, lane, bytes);
+    char b[24];
+    std::snprintf(b, sizeof(b), "0x%0*llX", bytes * 2, static_cast<unsigned long long>(v));
+    return b;
+}
+
 string hex8(uint32_t value) {
     stringstream ss;
     ss << "0x" 
@@ -182,6 +198,13 @@ void testFailedImpl(std::ofstream& outputFile, const std::vector<TestDetails>& t
     throw std::runtime_error("Test failed");
 }
 
+// One logged comparison, for the sections that check a value against what it should be.
+void checkResultImpl(std::ofstream& outputFile, std::vector<TestDetails>& tests, const char* file, int line, const string& testNum, const string& address, const string& expected, const string& actual, const string& testing, const string& note = "~") {
+    bool passed = expected == actual;
+    tests.push_back({getTimestamp(), testNum, address, expected, actual, passed ? "PASS" : "FAIL", testing, note});
+    if (!passed) testFailedImpl(outputFile, tests, file, line);
+}
+
 void writeByte(const char* path, uint64_t offset, uint8_t value) {
     std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
     
@@ -1250,6 +1273,46 @@ int main() {
             testFailed(outputFile, tests);
         }
 
+        memory.resetErrorResult();
+
+        memory.readBytesSpan(RAM_START - 1, 16);
+        if (memory.getTestingErrorResult() == true) {
+            tests.push_back({getTimestamp(), "1/2", hex8(RAM_START - 1), "True", "True", "PASS", "RAM Error test RA11AOOB (readBytesSpan)", "Error test"});
+        } else {
+            tests.push_back({getTimestamp(), "1/2", hex8(RAM_START - 1), "True", "False", "FAIL", "RAM Error test RA11AOOB (readBytesSpan)", "Error test"});
+            testFailed(outputFile, tests);
+        }
+
+        memory.resetErrorResult();
+
+        memory.readBytesSpan(RAM_END - 14, 16);
+        if (memory.getTestingErrorResult() == true) {
+            tests.push_back({getTimestamp(), "2/2   PASS", hex8(RAM_END - 14), "True", "True", "PASS", "RAM Error test RA11AOOB (readBytesSpan)", "Error test"});
+        } else {
+            tests.push_back({getTimestamp(), "2/2   FAIL", hex8(RAM_END - 14), "True", "False", "FAIL", "RAM Error test RA11AOOB (readBytesSpan)", "Error test"});
+            testFailed(outputFile, tests);
+        }
+
+        memory.resetErrorResult();
+
+        memory.writableBytesSpan(RAM_START - 1, 16);
+        if (memory.getTestingErrorResult() == true) {
+            tests.push_back({getTimestamp(), "1/2", hex8(RAM_START - 1), "True", "True", "PASS", "RAM Error test RA12AOOB (writableBytesSpan)", "Error test"});
+        } else {
+            tests.push_back({getTimestamp(), "1/2", hex8(RAM_START - 1), "True", "False", "FAIL", "RAM Error test RA12AOOB (writableBytesSpan)", "Error test"});
+            testFailed(outputFile, tests);
+        }
+
+        memory.resetErrorResult();
+
+        memory.writableBytesSpan(RAM_END - 14, 16);
+        if (memory.getTestingErrorResult() == true) {
+            tests.push_back({getTimestamp(), "2/2   PASS", hex8(RAM_END - 14), "True", "True", "PASS", "RAM Error test RA12AOOB (writableBytesSpan)", "Error test"});
+        } else {
+            tests.push_back({getTimestamp(), "2/2   FAIL", hex8(RAM_END - 14), "True", "False", "FAIL", "RAM Error test RA12AOOB (writableBytesSpan)", "Error test"});
+            testFailed(outputFile, tests);
+        }
+
 
         testBytes1 = {0x00};
         
@@ -1854,6 +1917,293 @@ int main() {
             testFailed(outputFile, tests);
         }
 
+        rom.resetErrorResult();
+
+        rom.readBytesSpan(ROM_START - 1, 16);
+        if (rom.getTestingErrorResult() == true) {
+            tests.push_back({getTimestamp(), "1/2", hex8(ROM_START - 1), "True", "True", "PASS", "ROM Error test RO09AOOB (readBytesSpan)", "Error test"});
+        } else {
+            tests.push_back({getTimestamp(), "1/2", hex8(ROM_START - 1), "True", "False", "FAIL", "ROM Error test RO09AOOB (readBytesSpan)", "Error test"});
+            testFailed(outputFile, tests);
+        }
+
+        rom.resetErrorResult();
+
+        rom.readBytesSpan(ROM_END - 14, 16);
+        if (rom.getTestingErrorResult() == true) {
+            tests.push_back({getTimestamp(), "2/2   PASS", hex8(ROM_END - 14), "True", "True", "PASS", "ROM Error test RO09AOOB (readBytesSpan)", "Error test"});
+        } else {
+            tests.push_back({getTimestamp(), "2/2   FAIL", hex8(ROM_END - 14), "True", "False", "FAIL", "ROM Error test RO09AOOB (readBytesSpan)", "Error test"});
+            testFailed(outputFile, tests);
+        }
+
+
+        // ASSEMBLER FLAG TABLE
+        // The peephole pass removes an instruction when a later one overwrites its flags, so a
+        // row must only list flags the CPU writes. Only vcmpeq sets ZERO among the vector ops.
+
+        checkResult(outputFile, tests, "1/4", "~", "0x00", hex2(findMnemonic("vadd8")->flagsWritten), "Assembler flags written (vadd8)", "Peephole");
+        checkResult(outputFile, tests, "2/4", "~", "0x00", hex2(findMnemonic("vumin32")->flagsWritten), "Assembler flags written (vumin32)", "Peephole");
+        checkResult(outputFile, tests, "3/4", "~", "0x00", hex2(findMnemonic("vsmax64")->flagsWritten), "Assembler flags written (vsmax64)", "Peephole");
+        checkResult(outputFile, tests, "4/4   PASS", "~", "0x40", hex2(findMnemonic("vcmpeq8")->flagsWritten), "Assembler flags written (vcmpeq8)", "Peephole");
+
+        // VECTOR UNIT
+        // Lane kernels behind the 0x02 opcodes. Whichever host path is compiled in (AVX2,
+        // SSE halves or scalar) has to give these results.
+
+        uint8_t va[VECTOR_BYTES], vb[VECTOR_BYTES], vd[VECTOR_BYTES];
+
+        for (int i = 0; i < VECTOR_BYTES; i++) {
+            va[i] = static_cast<uint8_t>(0xA0 + i);
+            vb[i] = static_cast<uint8_t>((31 - i) | (i & 1 ? 0xE0 : 0x00));
+        }
+        vectorShuffle(vd, va, vb);
+        checkResult(outputFile, tests, "1/14", "~", "0xBF", hex2(vd[0]), "Vector shuffle (high half into low)", "Index 31");
+        checkResult(outputFile, tests, "2/14", "~", "0xBE", hex2(vd[1]), "Vector shuffle (top index bits ignored)", "Index 0xFE");
+        checkResult(outputFile, tests, "3/14", "~", "0xA0", hex2(vd[31]), "Vector shuffle (low half into high)", "Index 0xE0");
+
+        for (int i = 0; i < VECTOR_BYTES; i++) {
+            va[i] = i & 1 ? 0xFF : 0x10;
+            vb[i] = i & 1 ? 0xFF : 0x11;
+        }
+        vectorArithmetic(VOP_MUL, 1, vd, va, vb);
+        checkResult(outputFile, tests, "4/14", "~", "0x0110", hexLane(vd, 2), "Vector mul8 (wraps per byte)", "0x10*0x11, 0xFF*0xFF");
+        checkResult(outputFile, tests, "5/14", "~", "0x0110", hexLane(vd + 30, 2), "Vector mul8 (top lanes)", "0x10*0x11, 0xFF*0xFF");
+
+        std::memset(va, 0x80, VECTOR_BYTES);
+        std::memset(vb, 0x7F, VECTOR_BYTES);
+        vectorArithmetic(VOP_UMIN, 1, vd, va, vb);
+        checkResult(outputFile, tests, "6/14", "~", "0x7F", hex2(vd[17]), "Vector umin8", "0x80 vs 0x7F");
+        vectorArithmetic(VOP_SMIN, 1, vd, va, vb);
+        checkResult(outputFile, tests, "7/14", "~", "0x80", hex2(vd[17]), "Vector smin8", "0x80 vs 0x7F");
+
+        for (int i = 0; i < VECTOR_BYTES; i += 2) {
+            va[i] = 0x00; va[i + 1] = 0x80;
+            vb[i] = 0xFF; vb[i + 1] = 0x7F;
+        }
+        vectorArithmetic(VOP_UMAX, 2, vd, va, vb);
+        checkResult(outputFile, tests, "8/14", "~", "0x8000", hexLane(vd + 20, 2), "Vector umax16", "0x8000 vs 0x7FFF");
+        vectorArithmetic(VOP_SMAX, 2, vd, va, vb);
+        checkResult(outputFile, tests, "9/14", "~", "0x7FFF", hexLane(vd + 20, 2), "Vector smax16", "0x8000 vs 0x7FFF");
+
+        for (int i = 0; i < VECTOR_BYTES; i += 8) {
+            uint64_t x = 0x8000000000000000ull, y = 1;
+            std::memcpy(va + i, &x, 8);
+            std::memcpy(vb + i, &y, 8);
+        }
+        vectorArithmetic(VOP_UMIN, 8, vd, va, vb);
+        checkResult(outputFile, tests, "10/14", "~", "0x0000000000000001", hexLane(vd + 24, 8), "Vector umin64", "2^63 vs 1");
+        vectorArithmetic(VOP_SMIN, 8, vd, va, vb);
+        checkResult(outputFile, tests, "11/14", "~", "0x8000000000000000", hexLane(vd + 24, 8), "Vector smin64", "2^63 vs 1");
+
+        for (int i = 0; i < VECTOR_BYTES; i++) {
+            va[i] = static_cast<uint8_t>(i);
+            vb[i] = static_cast<uint8_t>(i == 5 ? 0xEE : i);
+        }
+        vectorArithmetic(VOP_CMPEQ, 4, vd, va, vb);
+        checkResult(outputFile, tests, "12/14", "~", "0xFFFFFFFF", hexLane(vd, 4), "Vector cmpeq32 (equal lane)", "~");
+        checkResult(outputFile, tests, "13/14", "~", "0x00000000", hexLane(vd + 4, 4), "Vector cmpeq32 (one byte differs)", "Byte 5");
+        vectorArithmetic(VOP_CMPEQ, 8, vd, va, vb);
+        checkResult(outputFile, tests, "14/14   PASS", "~", "0x0000000000000000", hexLane(vd, 8), "Vector cmpeq64 (one byte differs)", "Byte 5");
+
+        // BULK MEMORY
+        // Kernels behind mcpy/mset/mcmp/mchr. Lengths 45 and 77 leave a 16 byte step and a
+        // scalar tail after the 32 byte loop. Results count from the low end of the block.
+
+        {
+            uint8_t x[45], y[45];
+            for (int i = 0; i < 45; i++) x[i] = y[i] = static_cast<uint8_t>(i * 7);
+
+            checkResult(outputFile, tests, "1/10", "~", "45", to_string(bulkCompare(x, y, 45)), "bulkCompare equal", "Length 45");
+            checkResult(outputFile, tests, "2/10", "~", "45", to_string(bulkCompareReverse(x, y, 45)), "bulkCompareReverse equal", "Length 45");
+
+            y[0] ^= 0xFF;
+            checkResult(outputFile, tests, "3/10", "~", "0", to_string(bulkCompare(x, y, 45)), "bulkCompare differs at 0", "~");
+            checkResult(outputFile, tests, "4/10", "~", "0", to_string(bulkCompareReverse(x, y, 45)), "bulkCompareReverse differs at 0", "Found last");
+
+            y[44] ^= 0xFF;
+            checkResult(outputFile, tests, "5/10", "~", "0", to_string(bulkCompare(x, y, 45)), "bulkCompare differs at 0 and 44", "~");
+            checkResult(outputFile, tests, "6/10", "~", "44", to_string(bulkCompareReverse(x, y, 45)), "bulkCompareReverse differs at 0 and 44", "~");
+
+            y[0] = x[0];
+            checkResult(outputFile, tests, "7/10", "~", "44", to_string(bulkCompare(x, y, 45)), "bulkCompare differs at length - 1", "Scalar tail");
+
+            y[44] = x[44];
+            y[40] = x[40] + 1;
+            checkResult(outputFile, tests, "8/10", "~", "40", to_string(bulkCompare(x, y, 45)), "bulkCompare differs at 40", "16 byte step");
+            checkResult(outputFile, tests, "9/10", "~", "40", to_string(bulkCompareReverse(x, y, 45)), "bulkCompareReverse differs at 40", "~");
+            checkResult(outputFile, tests, "10/10   PASS", "~", "7", to_string(bulkCompare(x, y, 7)), "bulkCompare scalar only", "Length 7, equal");
+        }
+
+        {
+            uint8_t p[77]{};
+
+            checkResult(outputFile, tests, "1/8", "~", "77", to_string(bulkFind(p, 0xAB, 77)), "bulkFind none", "Length 77");
+            checkResult(outputFile, tests, "2/8", "~", "77", to_string(bulkFindReverse(p, 0xAB, 77)), "bulkFindReverse none", "Length 77");
+
+            p[0] = p[76] = 0xAB;
+            checkResult(outputFile, tests, "3/8", "~", "0", to_string(bulkFind(p, 0xAB, 77)), "bulkFind at 0", "Also at 76");
+            checkResult(outputFile, tests, "4/8", "~", "76", to_string(bulkFindReverse(p, 0xAB, 77)), "bulkFindReverse at length - 1", "Also at 0");
+
+            p[76] = 0x00;
+            checkResult(outputFile, tests, "5/8", "~", "0", to_string(bulkFindReverse(p, 0xAB, 77)), "bulkFindReverse at 0", "Scalar tail");
+
+            p[0] = 0x00;
+            p[70] = 0xAB;
+            checkResult(outputFile, tests, "6/8", "~", "70", to_string(bulkFind(p, 0xAB, 77)), "bulkFind in the tail", "Index 70");
+
+            p[70] = 0x00;
+            p[3] = 0xAB;
+            checkResult(outputFile, tests, "7/8", "~", "3", to_string(bulkFindReverse(p, 0xAB, 77)), "bulkFindReverse in the tail", "Index 3");
+            checkResult(outputFile, tests, "8/8   PASS", "~", "3", to_string(bulkFind(p, 0xAB, 77)), "bulkFind at 3", "~");
+        }
+
+        {
+            // FLAG_DIRECTION: mcmp counts the offset in run direction and sets CARRY from the
+            // differing byte, mchr returns the match counted from the low end.
+            uint8_t x[45], y[45];
+            for (int i = 0; i < 45; i++) x[i] = y[i] = static_cast<uint8_t>(i);
+            bool below = true;
+            auto compareRun = [&](bool downwards) {
+                size_t offset = bulkCompareRun(x, y, 45, downwards, below);
+                return to_string(offset) + " " + to_string(below);
+            };
+
+            checkResult(outputFile, tests, "1/9", "~", "45 0", compareRun(true), "mcmp down equal (ZERO)", "Offset, CARRY");
+
+            y[2]  = 0x00;   // x[2] = 2 above
+            y[40] = 0xFF;   // x[40] = 40 below
+            checkResult(outputFile, tests, "2/9", "~", "2 0", compareRun(false), "mcmp up offset and CARRY", "Byte 2, above");
+            checkResult(outputFile, tests, "3/9", "~", "4 1", compareRun(true), "mcmp down offset and CARRY", "Byte 40, below");
+
+            y[2] = x[2];
+            y[40] = x[40];
+            y[44] = 0x00;
+            checkResult(outputFile, tests, "4/9", "~", "0 0", compareRun(true), "mcmp down differs at highest byte", "~");
+            checkResult(outputFile, tests, "5/9", "~", "44 0", compareRun(false), "mcmp up differs at highest byte", "~");
+
+            y[44] = x[44];
+            y[0] = 0xFF;
+            checkResult(outputFile, tests, "6/9", "~", "44 1", compareRun(true), "mcmp down differs at lowest byte", "~");
+
+            x[10] = x[30] = 0xEE;
+            checkResult(outputFile, tests, "7/9", "~", "30", to_string(bulkFindRun(x, 0xEE, 45, true)), "mchr down index from low end", "Matches at 10, 30");
+            checkResult(outputFile, tests, "8/9", "~", "10", to_string(bulkFindRun(x, 0xEE, 45, false)), "mchr up index from low end", "Matches at 10, 30");
+            checkResult(outputFile, tests, "9/9   PASS", "~", "241", to_string(bulkLowEnd(0x100, 16)), "Direction low end of a block", "Highest 0x100, length 16");
+        }
+
+        // INTERRUPT CONTROLLER
+        // Vectors are results of acknowledge() in decimal, -1 when nothing is deliverable.
+
+        std::atomic<bool> icuHint = false;
+
+        {
+            InterruptController icu(icuHint);
+            icu.raise(0x21);
+            icu.raise(0x35);
+            checkResult(outputFile, tests, "1/4", "~", "1", to_string(icuHint.load()), "ICU raise sets the CPU hint", "~");
+            checkResult(outputFile, tests, "2/4", "~", "53", to_string(icu.acknowledge()), "ICU back to back raises (higher first)", "0x21 then 0x35");
+            checkResult(outputFile, tests, "3/4", "~", "-1", to_string(icu.acknowledge()), "ICU back to back raises (lower class waits)", "0x35 in service");
+            icu.writePort(ICU_REG_EOI, 0, 1);
+            checkResult(outputFile, tests, "4/4   PASS", "~", "33", to_string(icu.acknowledge()), "ICU back to back raises (both delivered)", "After EOI");
+        }
+
+        {
+            InterruptController icu(icuHint);
+            icu.writePort(ICU_REG_MASK + 8, 0x01, 1);
+            icu.raise(0x40);
+            checkResult(outputFile, tests, "1/4", "~", "-1", to_string(icu.acknowledge()), "ICU masked vector is held", "0x40 masked");
+            checkResult(outputFile, tests, "2/4", "~", "1", to_string(icu.readPort(ICU_REG_PENDING + 8, 1)), "ICU masked vector stays pending", "~");
+            icu.writePort(ICU_REG_MASK + 8, 0x00, 1);
+            checkResult(outputFile, tests, "3/4", "~", "1", to_string(icuHint.load()), "ICU unmask sets the CPU hint", "~");
+            checkResult(outputFile, tests, "4/4   PASS", "~", "64", to_string(icu.acknowledge()), "ICU masked vector released", "After unmask");
+        }
+
+        {
+            InterruptController icu(icuHint);
+            icu.raise(0x50);
+            icu.acknowledge();
+            icu.raise(0x5F);
+            checkResult(outputFile, tests, "1/5", "~", "-1", to_string(icu.acknowledge()), "ICU same class does not nest", "0x5F over 0x50");
+            icu.raise(0x60);
+            checkResult(outputFile, tests, "2/5", "~", "96", to_string(icu.acknowledge()), "ICU higher class nests", "0x60 over 0x50");
+            icu.writePort(ICU_REG_EOI, 0, 1);
+            checkResult(outputFile, tests, "3/5", "~", "-1", to_string(icu.acknowledge()), "ICU EOI ends the newest handler only", "0x50 still in service");
+            checkResult(outputFile, tests, "4/5", "~", "1", to_string(icu.readPort(ICU_REG_IN_SERVICE + 8, 8) >> 16), "ICU in service after one EOI", "Bit of 0x50");
+            icu.writePort(ICU_REG_EOI, 0, 1);
+            checkResult(outputFile, tests, "5/5   PASS", "~", "95", to_string(icu.acknowledge()), "ICU same class delivered after EOI", "~");
+        }
+
+        {
+            InterruptController icu(icuHint);
+            icu.writePort(ICU_REG_CONTROL, ICU_CONTROL_AUTO_EOI, 1);
+            icu.raise(0x30);
+            checkResult(outputFile, tests, "1/3", "~", "48", to_string(icu.acknowledge()), "ICU auto EOI delivers", "~");
+            checkResult(outputFile, tests, "2/3", "~", "0", to_string(icu.readPort(ICU_REG_IN_SERVICE, 8)), "ICU auto EOI leaves nothing in service", "~");
+            icu.raise(0x31);
+            checkResult(outputFile, tests, "3/3   PASS", "~", "49", to_string(icu.acknowledge()), "ICU auto EOI same class without EOI", "~");
+        }
+
+        // UART RECEIVE
+        // receive() is the host side of RX; the guest sees the bytes through the data register.
+
+        {
+            InterruptController icu(icuHint);
+            UARTController uart(icu);
+            const uint8_t input[] = {'h', 'i'};
+
+            uart.receive(input, 1);
+            checkResult(outputFile, tests, "1/8", "~", "-1", to_string(icu.acknowledge()), "UART RX interrupt off", "CONTROL 0");
+            uart.readPort(UART_REG_DATA, 1);
+
+            uart.writePort(UART_REG_CONTROL, UART_CONTROL_RX_INTERRUPT | (0x42 << 8), 2);
+            uart.receive(input, 2);
+            checkResult(outputFile, tests, "2/8", "~", "66", to_string(icu.acknowledge()), "UART RX interrupt raised", "Vector 0x42");
+            checkResult(outputFile, tests, "3/8", "~", "2", to_string(uart.readPort(UART_REG_RX_COUNT, 4)), "UART RX count", "~");
+            checkResult(outputFile, tests, "4/8", "~", "0x68", hex2(uart.readPort(UART_REG_DATA, 1)), "UART RX first byte", "'h'");
+            checkResult(outputFile, tests, "5/8", "~", "0x69", hex2(uart.readPort(UART_REG_DATA, 1)), "UART RX second byte", "'i'");
+            checkResult(outputFile, tests, "6/8", "~", "0", to_string(uart.readPort(UART_REG_STATUS, 1) & UART_STATUS_RX_READY), "UART RX empty", "~");
+
+            std::vector<uint8_t> flood(UART_RX_FIFO_SIZE + 1, 'x');
+            uart.receive(flood.data(), flood.size());
+            checkResult(outputFile, tests, "7/8", "~", to_string(UART_RX_FIFO_SIZE), to_string(uart.readPort(UART_REG_RX_COUNT, 4)), "UART RX FIFO full", "One byte over");
+            checkResult(outputFile, tests, "8/8   PASS", "~", to_string(UART_STATUS_RX_OVERRUN), to_string(uart.readPort(UART_REG_STATUS, 1) & UART_STATUS_RX_OVERRUN), "UART RX overrun", "~");
+        }
+
+        // LINKER
+        // Objects are built in memory. A relocation field holds its addend before linking.
+
+        {
+            Linker link;
+            link.testing = true;
+            link.add("caller", {{{"code", {0xAA, 0x02, 0, 0, 0, 0, 0, 0, 0, 0x03, 0}}}, {{"target", OBJECT_UNDEFINED, 0}}, {{0, 1, 8, 0}, {0, 9, 2, 0}}});
+            link.add("callee", {{{"code", {0x11, 0x22}}}, {{"target", 0, 1}}, {}});
+            link.link();
+            checkResult(outputFile, tests, "1/4", "~", "12", to_string(link.symbols["target"]), "Linker symbol address", "Second object at 11");
+            checkResult(outputFile, tests, "2/4", "~", "0x000000000000000E", hexLane(link.image.data() + 1, 8), "Linker 8 byte relocation", "Addend 2");
+            checkResult(outputFile, tests, "3/4", "~", "0x000F", hexLane(link.image.data() + 9, 2), "Linker 2 byte relocation", "Addend 3");
+            checkResult(outputFile, tests, "4/4   PASS", "~", "", link.testingError, "Linker no error", "~");
+        }
+
+        {
+            Linker link;
+            link.testing = true;
+            link.add("first", {{{"code", {0x00}}}, {{"twice", 0, 0}}, {}});
+            link.add("second", {{{"code", {0x00}}}, {{"twice", 0, 0}}, {}});
+            link.link();
+            checkResult(outputFile, tests, "1/2", "~", "LNK00002", link.testingError, "Linker duplicate symbol", "~");
+            checkResult(outputFile, tests, "2/2   PASS", "~", "0", to_string(link.symbols["twice"]), "Linker duplicate keeps the first", "~");
+        }
+
+        {
+            Linker link;
+            link.testing = true;
+            link.add("caller", {{{"code", {0xAA, 0x00, 0x00}}}, {{"missing", OBJECT_UNDEFINED, 0}}, {{0, 1, 2, 0}}});
+            link.link();
+            checkResult(outputFile, tests, "1/2", "~", "LNK00003", link.testingError, "Linker undefined symbol", "~");
+            checkResult(outputFile, tests, "2/2   PASS", "~", "0x0000", hexLane(link.image.data() + 1, 2), "Linker leaves the field alone", "~");
+        }
+
         fillLog(outputFile, tests);
 
     } catch (const exception& error) {
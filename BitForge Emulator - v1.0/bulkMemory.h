@@ -0,0 +1,139 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <bit>
+#include <immintrin.h>
+
+// Host kernels behind mcpy/mset/mcmp/mchr. Compare and search return the index of the
+// first hit counted from the low end of the block, or length when there is none.
+
+inline void bulkCopy(uint8_t* target, const uint8_t* source, size_t length) {
+    std::memmove(target, source, length);
+}
+
+inline void bulkFill(uint8_t* target, uint8_t value, size_t length) {
+    std::memset(target, value, length);
+}
+
+inline size_t bulkCompare(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 32 <= length; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+        if (diff) return i + std::countr_zero(diff);
+    }
+#endif
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        uint32_t diff = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))) & 0xFFFF;
+        if (diff) return i + std::countr_zero(diff);
+    }
+
+    for (; i < length; i++)
+        if (a[i] != b[i]) return i;
+
+    return length;
+}
+
+inline size_t bulkCompareReverse(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = length;
+
+#if defined(__AVX2__)
+    for (; i >= 32; i -= 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 32));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i - 32));
+        uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+        if (diff) return i - 1 - std::countl_zero(diff);
+    }
+#endif
+
+    for (; i >= 16; i -= 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i - 16));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i - 16));
+        uint32_t diff = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))) & 0xFFFF;
+        if (diff) return i - 1 - (std::countl_zero(diff) - 16);
+    }
+
+    while (i > 0) {
+        i--;
+        if (a[i] != b[i]) return i;
+    }
+
+    return length;
+}
+
+inline size_t bulkFind(const uint8_t* p, uint8_t value, size_t length) {
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256i needle256 = _mm256_set1_epi8(static_cast<char>(value));
+    for (; i + 32 <= length; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle256)));
+        if (hit) return i + std::countr_zero(hit);
+    }
+#endif
+
+    __m128i needle128 = _mm_set1_epi8(static_cast<char>(value));
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        uint32_t hit = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle128)));
+        if (hit) return i + std::countr_zero(hit);
+    }
+
+    for (; i < length; i++)
+        if (p[i] == value) return i;
+
+    return length;
+}
+
+inline size_t bulkFindReverse(const uint8_t* p, uint8_t value, size_t length) {
+    size_t i = length;
+
+#if defined(__AVX2__)
+    __m256i needle256 = _mm256_set1_epi8(static_cast<char>(value));
+    for (; i >= 32; i -= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i - 32));
+        uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle256)));
+        if (hit) return i - 1 - std::countl_zero(hit);
+    }
+#endif
+
+    __m128i needle128 = _mm_set1_epi8(static_cast<char>(value));
+    for (; i >= 16; i -= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i - 16));
+        uint32_t hit = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle128)));
+        if (hit) return i - 1 - (std::countl_zero(hit) - 16);
+    }
+
+    while (i > 0) {
+        i--;
+        if (p[i] == value) return i;
+    }
+
+    return length;
+}
+
+// FLAG_DIRECTION set: the instruction's addresses point at the highest byte of the block.
+inline uint64_t bulkLowEnd(uint64_t highest, uint64_t length) {
+    return highest - (length - 1);
+}
+
+// mcmp: offset of the first differing byte counted in the run direction, length when the
+// blocks are equal. below is set when that byte of a is lower than b's (CARRY).
+inline size_t bulkCompareRun(const uint8_t* a, const uint8_t* b, size_t length, bool downwards, bool& below) {
+    size_t hit = downwards ? bulkCompareReverse(a, b, length) : bulkCompare(a, b, length);
+    below = hit != length && a[hit] < b[hit];
+    return hit == length || !downwards ? hit : length - 1 - hit;
+}
+
+// mchr: index of the first match in the run direction, counted from the low end, or length.
+inline size_t bulkFindRun(const uint8_t* p, uint8_t value, size_t length, bool downwards) {
+    return downwards ? bulkFindReverse(p, value, length) : bulkFind(p, value, length);
+}
@@ -0,0 +1,207 @@
+#include "channelController.h"
+#include "motherboard.h"
+#include <cstring>
+#include <algorithm>
+
+ChannelController::ChannelController(Motherboard* board) : motherboard(board) {}
+
+uint64_t ChannelController::registerValue(const Ring& ring, uint16_t offset, int size) const {
+    uint64_t value = 0;
+    for (int i = 0; i < size && offset + i < CHANNEL_REG_HEAD; i++)
+        value |= static_cast<uint64_t>(ring.registers[offset + i]) << (8 * i);
+    return value;
+}
+
+uint8_t* ChannelController::ringData(const Ring& ring) const {
+    return memory.memory.data() + (ring.address - Motherboard::RAM_START);
+}
+
+uint64_t ChannelController::readPort(uint16_t offset, int size) {
+    uint8_t bytes[CHANNEL_RING_STRIDE * CHANNEL_RING_COUNT]{};
+    for (int r = 0; r < CHANNEL_RING_COUNT; r++) {
+        Ring& ring = rings[r];
+        uint8_t* base = bytes + r * CHANNEL_RING_STRIDE;
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        uint64_t tail = ring.tail.load(std::memory_order_acquire);
+
+        std::memcpy(base, ring.registers, CHANNEL_REG_HEAD);
+        base[CHANNEL_REG_STATUS] = (ring.failed ? CHANNEL_STATUS_ERROR : 0) |
+                                   (head == tail ? CHANNEL_STATUS_EMPTY : 0) |
+                                   (ring.enabled && head - tail == ring.size ? CHANNEL_STATUS_FULL : 0);
+        for (int i = 0; i < 8; i++) {
+            base[CHANNEL_REG_HEAD + i] = (head >> (8 * i)) & 0xFF;
+            base[CHANNEL_REG_TAIL + i] = (tail >> (8 * i)) & 0xFF;
+        }
+    }
+
+    uint64_t value = 0;
+    for (int i = 0; i < size && offset + i < CHANNEL_RING_STRIDE * CHANNEL_RING_COUNT; i++)
+        value |= static_cast<uint64_t>(bytes[offset + i]) << (8 * i);
+    return value;
+}
+
+void ChannelController::writePort(uint16_t offset, uint64_t value, int size) {
+    bool     controlWritten[CHANNEL_RING_COUNT]{};
+    bool     indexWritten[CHANNEL_RING_COUNT]{};
+    uint64_t index[CHANNEL_RING_COUNT];
+
+    // The guest's own index: the tail of the input ring, the head of the output ring.
+    index[CHANNEL_RING_INPUT]  = rings[CHANNEL_RING_INPUT].tail.load(std::memory_order_relaxed);
+    index[CHANNEL_RING_OUTPUT] = rings[CHANNEL_RING_OUTPUT].head.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < size && offset + i < CHANNEL_RING_STRIDE * CHANNEL_RING_COUNT; i++) {
+        int r = (offset + i) / CHANNEL_RING_STRIDE;
+        uint16_t field = (offset + i) % CHANNEL_RING_STRIDE;
+        uint64_t byte = (value >> (8 * i)) & 0xFF;
+
+        uint16_t guestIndex = r == CHANNEL_RING_INPUT ? CHANNEL_REG_TAIL : CHANNEL_REG_HEAD;
+        if (field >= guestIndex && field < guestIndex + 8) {
+            int shift = 8 * (field - guestIndex);
+            index[r] = (index[r] & ~(0xFFull << shift)) | (byte << shift);
+            indexWritten[r] = true;
+        } else if (field < CHANNEL_REG_HEAD && field != CHANNEL_REG_STATUS) {
+            rings[r].registers[field] = static_cast<uint8_t>(byte);
+            if (field == CHANNEL_REG_CONTROL) controlWritten[r] = true;
+        }
+    }
+
+    for (int r = 0; r < CHANNEL_RING_COUNT; r++) {
+        if (controlWritten[r]) configure(rings[r]);
+        if (indexWritten[r]) moveGuestIndex(r, index[r]);
+    }
+}
+
+// Writing control applies address, size and vector and empties the ring. The size has to be a power
+// of two and the whole ring has to be in RAM, or the error bit is set and the ring stays off.
+void ChannelController::configure(Ring& ring) {
+    uint64_t address = registerValue(ring, CHANNEL_REG_ADDRESS, 8);
+    uint64_t size    = registerValue(ring, CHANNEL_REG_SIZE, 4);
+
+    uint8_t control = ring.registers[CHANNEL_REG_CONTROL];
+
+    ring.enabled = false;
+    ring.failed = false;
+    ring.head = 0;
+    ring.tail = 0;
+    ring.vector = (control & CHANNEL_CONTROL_INTERRUPT) ? ring.registers[CHANNEL_REG_VECTOR] : -1;
+    if (!(control & CHANNEL_CONTROL_ENABLE)) return;
+
+    if (size == 0 || (size & (size - 1)) || address < Motherboard::RAM_START ||
+        address + size - 1 > Motherboard::RAM_END) {
+        ring.failed = true;
+        return;
+    }
+
+    ring.address = address;
+    ring.size = size;
+    ring.enabled.store(true, std::memory_order_release);
+
+    if (guestDoorbell) guestDoorbell();
+}
+
+// Guest doorbell. The index may only move forward, and never past the other side.
+void ChannelController::moveGuestIndex(int index, uint64_t value) {
+    Ring& ring = rings[index];
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t tail = ring.tail.load(std::memory_order_acquire);
+
+    bool valid = index == CHANNEL_RING_INPUT
+        ? value >= tail && value <= head
+        : value >= head && value - tail <= ring.size;
+
+    if (!ring.enabled || !valid) {
+        ring.failed = true;
+        return;
+    }
+
+    if (value == (index == CHANNEL_RING_INPUT ? tail : head)) return;
+
+    if (index == CHANNEL_RING_INPUT) ring.tail.store(value, std::memory_order_release);
+    else ring.head.store(value, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(doorbellMutex);
+        doorbells++;
+    }
+    doorbell.notify_all();
+
+    if (guestDoorbell) guestDoorbell();
+}
+
+void ChannelController::notifyGuest(int index) {
+    int vector = rings[index].vector.load(std::memory_order_relaxed);
+    if (vector >= 0) motherboard->raiseInterrupt(static_cast<uint8_t>(vector));
+}
+
+std::span<uint8_t> ChannelController::inputWritable() {
+    const Ring& ring = rings[CHANNEL_RING_INPUT];
+    if (!ring.enabled.load(std::memory_order_acquire)) return {};
+
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    uint64_t tail = ring.tail.load(std::memory_order_acquire);
+    uint64_t start = head & (ring.size - 1);
+    uint64_t length = std::min(ring.size - (head - tail), ring.size - start);
+    return {ringData(ring) + start, static_cast<size_t>(length)};
+}
+
+void ChannelController::inputProduced(size_t length) {
+    Ring& ring = rings[CHANNEL_RING_INPUT];
+    if (!ring.enabled.load(std::memory_order_acquire) || length == 0) return;
+
+    ring.head.fetch_add(length, std::memory_order_release);
+    notifyGuest(CHANNEL_RING_INPUT);
+}
+
+std::span<const uint8_t> ChannelController::outputReadable() {
+    const Ring& ring = rings[CHANNEL_RING_OUTPUT];
+    if (!ring.enabled.load(std::memory_order_acquire)) return {};
+
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    uint64_t start = tail & (ring.size - 1);
+    uint64_t length = std::min(head - tail, ring.size - start);
+    return {ringData(ring) + start, static_cast<size_t>(length)};
+}
+
+void ChannelController::outputConsumed(size_t length) {
+    Ring& ring = rings[CHANNEL_RING_OUTPUT];
+    if (!ring.enabled.load(std::memory_order_acquire) || length == 0) return;
+
+    ring.tail.fetch_add(length, std::memory_order_release);
+    notifyGuest(CHANNEL_RING_OUTPUT);
+}
+
+// At most two copies each: up to the end of the ring, then from its start.
+size_t ChannelController::push(const uint8_t* bytes, size_t length) {
+    size_t done = 0;
+    for (int part = 0; part < 2 && done < length; part++) {
+        std::span<uint8_t> free = inputWritable();
+        size_t n = std::min(free.size(), length - done);
+        if (n == 0) break;
+
+        std::memcpy(free.data(), bytes + done, n);
+        inputProduced(n);
+        done += n;
+    }
+    return done;
+}
+
+size_t ChannelController::pull(uint8_t* bytes, size_t length) {
+    size_t done = 0;
+    for (int part = 0; part < 2 && done < length; part++) {
+        std::span<const uint8_t> filled = outputReadable();
+        size_t n = std::min(filled.size(), length - done);
+        if (n == 0) break;
+
+        std::memcpy(bytes + done, filled.data(), n);
+        outputConsumed(n);
+        done += n;
+    }
+    return done;
+}
+
+bool ChannelController::waitForGuest(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(doorbellMutex);
+    uint64_t seen = doorbells;
+    return doorbell.wait_for(lock, timeout, [&] { return doorbells != seen; });
+}
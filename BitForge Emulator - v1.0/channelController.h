@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include "device.h"
+
+class Motherboard;
+
+static constexpr int      CHANNEL_RING_INPUT  = 0;   // host produces, guest consumes
+static constexpr int      CHANNEL_RING_OUTPUT = 1;   // guest produces, host consumes
+static constexpr int      CHANNEL_RING_COUNT  = 2;
+static constexpr uint16_t CHANNEL_RING_STRIDE = 0x20;
+
+static constexpr uint16_t CHANNEL_REG_ADDRESS = 0x00;
+static constexpr uint16_t CHANNEL_REG_SIZE    = 0x08;
+static constexpr uint16_t CHANNEL_REG_VECTOR  = 0x0C;
+static constexpr uint16_t CHANNEL_REG_CONTROL = 0x0D;
+static constexpr uint16_t CHANNEL_REG_STATUS  = 0x0E;
+static constexpr uint16_t CHANNEL_REG_HEAD    = 0x10;
+static constexpr uint16_t CHANNEL_REG_TAIL    = 0x18;
+
+static constexpr uint8_t CHANNEL_CONTROL_ENABLE    = 1 << 0;
+static constexpr uint8_t CHANNEL_CONTROL_INTERRUPT = 1 << 1;
+
+static constexpr uint8_t CHANNEL_STATUS_ERROR = 1 << 0;
+static constexpr uint8_t CHANNEL_STATUS_EMPTY = 1 << 1;
+static constexpr uint8_t CHANNEL_STATUS_FULL  = 1 << 2;
+
+// Two single producer, single consumer rings that live in guest RAM. Head and tail are free
+// running byte counts (position = count & (size - 1)). Each side only ever moves its own index,
+// so the data itself is never copied by the device: the host writes into or reads out of the
+// ring in guest RAM, and the guest works on it in place.
+class ChannelController : public Device {
+public:
+    Motherboard* motherboard = nullptr;
+
+    ChannelController(Motherboard* board);
+
+    uint64_t readPort (uint16_t offset, int size) override;
+    void     writePort(uint16_t offset, uint64_t value, int size) override;
+
+    // Host side, one host thread per ring. writable/readable return the contiguous free or
+    // filled part of the ring (empty while the ring is disabled); produced/consumed publish it
+    // to the guest and raise the ring's vector if interrupts are on.
+    std::span<uint8_t>       inputWritable();
+    void                     inputProduced(size_t length);
+    std::span<const uint8_t> outputReadable();
+    void                     outputConsumed(size_t length);
+
+    // Copying helpers on top of the above. Return how many bytes fit or were available.
+    size_t push(const uint8_t* bytes, size_t length);
+    size_t pull(uint8_t* bytes, size_t length);
+
+    // Waits until the guest moves an index (a doorbell) or the timeout passes.
+    bool   waitForGuest(std::chrono::milliseconds timeout);
+
+    // Also called on the CPU thread for every guest doorbell and ring configuration, for host
+    // sides that wait on something other than waitForGuest (the socket bridge's event loop).
+    // Set it before the CPU starts.
+    std::function<void()> guestDoorbell;
+
+private:
+    // registers and failed belong to the CPU thread. The host side only reads enabled (which
+    // publishes address and size), the other side's index and vector, so neither side locks.
+    struct Ring {
+        uint8_t  registers[CHANNEL_REG_HEAD]{};
+        bool     failed = false;
+        uint64_t address = 0;
+        uint64_t size = 0;
+        std::atomic<bool>     enabled = false;
+        std::atomic<int>      vector = -1;
+        std::atomic<uint64_t> head = 0;
+        std::atomic<uint64_t> tail = 0;
+    };
+
+    Ring rings[CHANNEL_RING_COUNT];
+
+    std::mutex              doorbellMutex;
+    std::condition_variable doorbell;
+    uint64_t                doorbells = 0;
+
+    uint64_t registerValue(const Ring& ring, uint16_t offset, int size) const;
+    void     configure(Ring& ring);
+    void     moveGuestIndex(int index, uint64_t value);
+    uint8_t* ringData(const Ring& ring) const;
+    void     notifyGuest(int index);
+};
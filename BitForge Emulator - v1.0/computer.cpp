@@ -1,7 +1,23 @@
 #include "motherboard.h"
+#include "framebufferShared.h"
+#include <string>
 
-int main() {
-    Motherboard motherboard;
+// computer.exe [--virtual-time] [--socket path] [--framebuffer name]
+int main(int argc, char* argv[]) {
+    bool virtualTime = false;
+    std::string socketPath;
+    std::string framebufferName = FB_DEFAULT_NAME;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--virtual-time") virtualTime = true;
+        else if (arg == "--socket" && i + 1 < argc) socketPath = argv[++i];
+        else if (arg == "--framebuffer" && i + 1 < argc) framebufferName = argv[++i];
+    }
+
+    Motherboard motherboard(virtualTime);
+    motherboard.shareFramebuffer(framebufferName);
+    if (!socketPath.empty()) motherboard.startSocketBridge(socketPath);
     motherboard.run();
     return 0;
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "rom.h"
 #include "ram.h"
 #include "storage.h"
+#include "bulkMemory.h"
+#include "interruptController.h"
 #include <iostream>
 #include <string>
 #include <thread>
@@ -14,8 +16,9 @@
 #include <immintrin.h>
 
 void CPU::start() {
-    stackPointer = STACK_END;
+    stackPointer = STACK_START;
     running = true;
+    hostStart = std::chrono::steady_clock::now();
 
     for (int i = 0; i < 1000; i++) {
         warmup = rom->read8(Motherboard::ROM_START + (i % Motherboard::ROM_SIZE));
@@ -24,17 +27,25 @@ void CPU::start() {
     timer.start();
 
     while (running) {
+        if (cycles >= nextEventCycle) motherboard->runEvents();
         checkInterrupts();
         if (!getFlagBit(FLAG_SLEEP)) {
             fetch();
             decode();
             execute();
+        } else if (sleepTimed && guestMicros() >= sleepDeadline) {
+            sleepTimed = false;
+            setFlagBit(FLAG_SLEEP, false);
+        } else if (virtualTime) {
+            skipIdleTime();
         }
         cycles++;
     }
     
     CPURunTime = timer.end();
 
+    if (motherboard) motherboard->flushDevices();
+
     std::cout << std::fixed << std::setprecision(10)
           << "CPU Finished in " << cycles
           << " cycles in " << CPURunTime << " seconds.\n";
@@ -96,12 +107,30 @@ void CPU::start() {
     std::cin.get();
 }
 
+uint64_t CPU::guestMicros() const {
+    if (virtualTime) return cycles / Motherboard::VIRTUAL_CYCLES_PER_US;
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+// Virtual time only. Nothing can happen while the CPU sleeps until the sleep ends or the next
+// timer event is due, so the cycle counter jumps to whichever comes first. A wait with no
+// timer armed keeps spinning, since host side devices (disk, DMA, UART) may still interrupt.
+void CPU::skipIdleTime() {
+    uint64_t target = nextEventCycle;
+    if (sleepTimed) target = (std::min)(target, sleepDeadline * Motherboard::VIRTUAL_CYCLES_PER_US);
+
+    if (target != UINT64_MAX && target > cycles + 1) cycles = target - 1;
+}
+
 void CPU::triggerInterrupt(uint8_t vector) {
+    setFlagBit(FLAG_SLEEP, false);
+    sleepTimed = false;
+
+    write64(stackPointer - 7, instructionPointer);
     stackPointer -= 8;
-    write64(stackPointer, instructionPointer);
 
-    stackPointer -= 1;
     write8(stackPointer, flags);
+    stackPointer -= 1;
 
     setFlagBit(FLAG_INTERRUPT, false);
 
@@ -116,11 +145,11 @@ void CPU::checkInterrupts() {
         return;
     }
 
-    if (!pendingInterrupt) return;
+    if (!pendingInterrupt.load(std::memory_order_acquire)) return;
     if (!getFlagBit(FLAG_INTERRUPT)) return;
 
-    triggerInterrupt(interruptNumber);
-    pendingInterrupt = false;
+    int vector = motherboard->interruptController->acknowledge();
+    if (vector != ICU_NO_VECTOR) triggerInterrupt(static_cast<uint8_t>(vector));
 }
 
 void CPU::fetch() {
@@ -170,6 +199,7 @@ void CPU::decode() {
         case 0xEC: case 0xED: case 0xEE: case 0xEF:
         case 0x012A: case 0x012B: case 0x012C: case 0x012D:
         case 0x012E: case 0x012F: case 0x0130: case 0x0131:
+        case 0x0221: case 0x0222:
             op1Size = 0;
             op2Size = 0;
 
@@ -246,8 +276,6 @@ void CPU::decode() {
 
             instructionPointer += op1Size;
 
-            operandsVector.clear();
-
             if (op2Size == 0) {
                 op2Size = read16(instructionPointer);
             }
@@ -258,7 +286,10 @@ void CPU::decode() {
 
             instructionPointer += 2;
 
-            if (op2Size == 1) {
+            if (op2Type == imm) {
+                operandSpan = readBytesSpan(instructionPointer, op2Size);
+
+            } else if (op2Size == 1) {
                 operands8[op8Index++] = read8(instructionPointer);
 
             } else if (op2Size == 2) {
@@ -269,12 +300,9 @@ void CPU::decode() {
 
             } else if (op2Size == 8) {
                 operands64[op64Index++] = read64(instructionPointer);
-
-            } else {
-                operandsVector.push_back(readBytesVector(instructionPointer, op2Size));
             }
 
-            instructionPointer += op2Size + op2VectorSize;
+            instructionPointer += op2Size;
             break;
 
         case 0x15: case 0x16: case 0x17: case 0x18: case 0x19: case 0x1A:
@@ -308,6 +336,16 @@ void CPU::decode() {
         case 0xCC: case 0xCD: case 0xCE: case 0xCF:
         case 0xD0: case 0xD1: case 0xD2: case 0xD3:
         case 0xD4: case 0xD5: case 0x0128: case 0x0129:
+        case 0x013E: case 0x013F: case 0x0140: case 0x0141:
+        case 0x0200: case 0x0201: case 0x0202: case 0x0203:
+        case 0x0204: case 0x0205: case 0x0206: case 0x0207:
+        case 0x0208: case 0x0209: case 0x020A: case 0x020B:
+        case 0x020C: case 0x020D: case 0x020E: case 0x020F:
+        case 0x0210: case 0x0211: case 0x0212: case 0x0213:
+        case 0x0214: case 0x0215: case 0x0216: case 0x0217:
+        case 0x0218: case 0x0219: case 0x021A: case 0x021B:
+        case 0x021C: case 0x021D: case 0x021E: case 0x021F:
+        case 0x0220:
             op1Size = 0;
             op2Size = 0;
             op3Size = 0;
@@ -414,6 +452,7 @@ void CPU::decode() {
 
         case 0xD6: case 0xD7: case 0xD8: case 0xD9:
         case 0xDA: case 0xDB: case 0xDC: case 0xDD:
+        case 0x0142: case 0x0143:
             op1Size = 0;
             op2Size = 0;
             op3Size = 0;
@@ -850,7 +889,8 @@ void CPU::execute() {
 
             switch (op2Type) {
                 case imm:
-                    VectorOfBytesPointer = &operandsVector[opVectorIndex]; opVectorIndex++; break;
+                    sourceSpan = operandSpan;
+                    break;
 
                 case mem_imm:
                     switch (op2Size) {
@@ -860,8 +900,7 @@ void CPU::execute() {
                         case 8: addr = operands64[op64Index]; break;
                     }
 
-                    VectorOfBytes = readBytesVector(addr, op2VectorSize);
-                    VectorOfBytesPointer = &VectorOfBytes;
+                    sourceSpan = readBytesSpan(addr, op2VectorSize);
                     break;
 
                 case mem_reg:
@@ -872,21 +911,24 @@ void CPU::execute() {
                         case 8: addr = registers[operands64[op64Index]]; break;
                     }
 
-                    VectorOfBytes = readBytesVector(addr, op2VectorSize);
-                    VectorOfBytesPointer = &VectorOfBytes;
+                    sourceSpan = readBytesSpan(addr, op2VectorSize);
                     break;
             }
 
             switch (op1Type) {
                 case reg:
-                    registersNeeded = (VectorOfBytesPointer->size() + 7) / 8;
+                    registersNeeded = (sourceSpan.size() + 7) / 8;
+                    if (dest + registersNeeded > 64) {
+                        error("CP13CWTR", "Starting register: " + std::to_string(dest) + " + registers (" + std::to_string(registersNeeded) + ")");
+                    }
+
                     for (int i = 0; i < registersNeeded; i++) {
                         value = 0;
 
                         for (int b = 0; b < 8; b++) {
                             int idx = i * 8 + b;
-                            if (idx < VectorOfBytesPointer->size())
-                                value |= (uint64_t)(*VectorOfBytesPointer)[idx] << (b * 8);
+                            if (idx < sourceSpan.size())
+                                value |= (uint64_t)sourceSpan[idx] << (b * 8);
                         }
                         registers[dest + i] = value;
                     }
@@ -895,7 +937,10 @@ void CPU::execute() {
 
                 case mem_imm:
                 case mem_reg:
-                    writeBytesVector(dest, *VectorOfBytesPointer);
+                    if (!sourceSpan.empty()) {
+                        targetSpan = writableBytesSpan(dest, sourceSpan.size());
+                        bulkCopy(targetSpan.data(), sourceSpan.data(), sourceSpan.size());
+                    }
 
                     break;
             }
@@ -19778,6 +19823,7 @@ void CPU::execute() {
             break;
 
         case 0xFC:
+            sleepTimed = false;
             setFlagBit(FLAG_SLEEP, true);
             break;
 
@@ -19819,7 +19865,9 @@ void CPU::execute() {
                     break;
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(value));
+            sleepDeadline = guestMicros() + value * 1000;
+            sleepTimed = true;
+            setFlagBit(FLAG_SLEEP, true);
             break;
 
         case 0xFF:
@@ -19860,7 +19908,9 @@ void CPU::execute() {
                     break;
             }
             
-            std::this_thread::sleep_for(std::chrono::seconds(value));
+            sleepDeadline = guestMicros() + value * 1000000;
+            sleepTimed = true;
+            setFlagBit(FLAG_SLEEP, true);
             break;
 
         case 0x0100:
@@ -23843,7 +23893,7 @@ void CPU::execute() {
                     break;
 
                 case imm:
-                    switch (op3Size) {
+                    switch (op2Size) {
                         case 1: value1 = operands8[op8Index++]; break;
                         case 2: value1 = operands16[op16Index++]; break;
                         case 4: value1 = operands32[op32Index++]; break;
@@ -23961,7 +24011,7 @@ void CPU::execute() {
                     break;
 
                 case imm:
-                    switch (op3Size) {
+                    switch (op2Size) {
                         case 1: value1 = operands8[op8Index++]; break;
                         case 2: value1 = operands16[op16Index++]; break;
                         case 4: value1 = operands32[op32Index++]; break;
@@ -24669,156 +24719,1162 @@ void CPU::execute() {
             storage.writebytes64(dest, value1);
             break;
         
-        case 0xFD:
-        default:
-            running = false;
-            break;
-    }
-}
+        case 0x0140:
+            resetOpIndexes();
 
-uint8_t CPU::read8(uint64_t address) {
-    if (address >= Motherboard::ROM_START && address <= Motherboard::ROM_END) {
-        return rom->read8(address);
-    }
+            switch (op1Type) {
+                case reg:
+                    dest = registers[operands8[op8Index++]];
+                    break;
 
-    else if (address >= Motherboard::RAM_START && address <= Motherboard::RAM_END) {
-        return memory->read8(address);
-    }
+                case imm:
+                    switch (op1Size) {
+                        case 1: dest = operands8[op8Index++]; break;
+                        case 2: dest = operands16[op16Index++]; break;
+                        case 4: dest = operands32[op32Index++]; break;
+                        case 8: dest = operands64[op64Index++]; break;
+                    }
+                    break;
 
-    else {
-        error("CP03AOOB", "Absolute address: " + std::to_string(address));
-        return 0;
-    }
-}
+                case mem_imm:
+                    switch (op1Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
 
-uint16_t CPU::read16(uint64_t address) {
-    if (address >= Motherboard::ROM_START && address + 1 <= Motherboard::ROM_END) {
-        return rom->read16(address);
-    }
-    
-    else if (address >= Motherboard::RAM_START && address + 1 <= Motherboard::RAM_END) {
-        return memory->read16(address);
-    }
-    
-    else {
-        error("CP04AOOB", "Absolute address: " + std::to_string(address));
-        return 0;
-    }
-}
+                    dest = read64(addr);
+                    break;
 
-uint32_t CPU::read32(uint64_t address) {
-    if (address >= Motherboard::ROM_START && address + 3 <= Motherboard::ROM_END) {
-        return rom->read32(address);
-    }
-    
-    else if (address >= Motherboard::RAM_START && address + 3 <= Motherboard::RAM_END) {
-        return memory->read32(address);
-    }
-    
-    else {
-        error("CP05AOOB", "Absolute address: " + std::to_string(address));
-        return 0;
-    }
-}
+                case mem_reg:
+                    switch (op1Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
 
-uint64_t CPU::read64(uint64_t address) {
-    if (address >= Motherboard::ROM_START && address + 7 <= Motherboard::ROM_END) {
-        return rom->read64(address);
-    }
-    
-    else if (address >= Motherboard::RAM_START && address + 7 <= Motherboard::RAM_END) {
-        return memory->read64(address);
-    }
-    
-    else {
-        error("CP06AOOB", "Absolute address: " + std::to_string(address));
-        return 0;
-    }
-}
+                    dest = read64(addr);
+                    break;
+            }
 
-std::vector<uint8_t> CPU::readBytesVector(uint64_t start, size_t length) {
-    if (start >= Motherboard::ROM_START && start + length - 1 <= Motherboard::ROM_END) {
-        return rom->readBytesVector(start, length);
-    }
-    
-    else if (start >= Motherboard::RAM_START && start + length - 1 <= Motherboard::RAM_END) {
-        return memory->readBytesVector(start, length);
-    }
-    
-    else {
-        error("CP07AOOB", "Absolute address: " + std::to_string(start));
-        return {0};
-    }
-}
+            switch (op2Type) {
+                case reg:
+                    value1 = registers[operands8[op8Index++]];
+                    break;
 
-void CPU::write8(uint64_t address, uint8_t value) {
-    if (address >= Motherboard::ROM_START && address <= Motherboard::ROM_END) {
-        error("CP01CWTR", "Absolute address: " + std::to_string(address));
-    }
-    
-    else if (address >= Motherboard::RAM_START && address <= Motherboard::RAM_END) {
-        memory->write8(address, value);
-    }
-    
-    else {
-        error("CP08AOOB", "Absolute address: " + std::to_string(address));
-    }
-}
+                case imm:
+                    switch (op2Size) {
+                        case 1: value1 = operands8[op8Index++]; break;
+                        case 2: value1 = operands16[op16Index++]; break;
+                        case 4: value1 = operands32[op32Index++]; break;
+                        case 8: value1 = operands64[op64Index++]; break;
+                    }
+                    break;
 
-void CPU::write16(uint64_t address, uint16_t value) {
-    if (address >= Motherboard::ROM_START && address + 1 <= Motherboard::ROM_END) {
-        error("CP01CWTR", "Absolute address: " + std::to_string(address));
-    }
-    
-    else if (address >= Motherboard::RAM_START && address + 1 <= Motherboard::RAM_END) {
-        memory->write16(address, value);
-    }
-    
-    else {
-        error("CP09AOOB", "Absolute address: " + std::to_string(address));
-    }
-}
+                case mem_imm:
+                    switch (op2Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
 
-void CPU::write32(uint64_t address, uint32_t value) {
-    if (address >= Motherboard::ROM_START && address + 3 <= Motherboard::ROM_END) {
-        error("CP01CWTR", "Absolute address: " + std::to_string(address));
-    }
-    
-    else if (address >= Motherboard::RAM_START && address + 3 <= Motherboard::RAM_END) {
-        memory->write32(address, value);
-    }
+                    value1 = read64(addr);
+                    break;
 
-    else {
-        error("CP10AOOB", "Absolute address: " + std::to_string(address));
-    }
-}
+                case mem_reg:
+                    switch (op2Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
 
-void CPU::write64(uint64_t address, uint64_t value) {
-    if (address >= Motherboard::ROM_START && address + 7 <= Motherboard::ROM_END) {
-        error("CP01CWTR", "Absolute address: " + std::to_string(address));
-    }
-    
-    else if (address >= Motherboard::RAM_START && address + 7 <= Motherboard::RAM_END) {
-        memory->write64(address, value);
-    }
-    
-    else {
-        error("CP11AOOB", "Absolute address: " + std::to_string(address));
-    }
-}
+                    value1 = read64(addr);
+                    break;
+            }
 
-void CPU::writeBytesVector(uint64_t start, const std::vector<uint8_t>& data) {
-    if (start >= Motherboard::ROM_START && start + data.size() - 1 <= Motherboard::ROM_END) {
-        error("CP02CWTR", "Absolute address: " + std::to_string(start));
-    }
-    
-    else if (start >= Motherboard::RAM_START && start + data.size() - 1 <= Motherboard::RAM_END) {
-        memory->writeBytesVector(start, data);
-    }
-    
-    else {
-        error("CP12AOOB", "Absolute address: " + std::to_string(start));
-    }
+            switch (op3Type) {
+                case reg:
+                    value2 = registers[operands8[op8Index]];
+                    break;
+
+                case imm:
+                    switch (op3Size) {
+                        case 1: value2 = operands8[op8Index]; break;
+                        case 2: value2 = operands16[op16Index]; break;
+                        case 4: value2 = operands32[op32Index]; break;
+                        case 8: value2 = operands64[op64Index]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op3Size) {
+                        case 1: addr = operands8[op8Index]; break;
+                        case 2: addr = operands16[op16Index]; break;
+                        case 4: addr = operands32[op32Index]; break;
+                        case 8: addr = operands64[op64Index]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op3Size) {
+                        case 1: addr = registers[operands8[op8Index]]; break;
+                        case 2: addr = registers[operands16[op16Index]]; break;
+                        case 4: addr = registers[operands32[op32Index]]; break;
+                        case 8: addr = registers[operands64[op64Index]]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+            }
+
+            if (value2 == 0) break;
+
+            if (getFlagBit(FLAG_DIRECTION)) {
+                dest = bulkLowEnd(dest, value2);
+                value1 = bulkLowEnd(value1, value2);
+            }
+
+            sourceSpan = readBytesSpan(value1, value2);
+            targetSpan = writableBytesSpan(dest, value2);
+            bulkCopy(targetSpan.data(), sourceSpan.data(), value2);
+            break;
+
+        case 0x0141:
+            resetOpIndexes();
+
+            switch (op1Type) {
+                case reg:
+                    dest = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op1Size) {
+                        case 1: dest = operands8[op8Index++]; break;
+                        case 2: dest = operands16[op16Index++]; break;
+                        case 4: dest = operands32[op32Index++]; break;
+                        case 8: dest = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op1Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    dest = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op1Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    dest = read64(addr);
+                    break;
+            }
+
+            switch (op2Type) {
+                case reg:
+                    value1 = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op2Size) {
+                        case 1: value1 = operands8[op8Index++]; break;
+                        case 2: value1 = operands16[op16Index++]; break;
+                        case 4: value1 = operands32[op32Index++]; break;
+                        case 8: value1 = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op2Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op2Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+            }
+
+            switch (op3Type) {
+                case reg:
+                    value2 = registers[operands8[op8Index]];
+                    break;
+
+                case imm:
+                    switch (op3Size) {
+                        case 1: value2 = operands8[op8Index]; break;
+                        case 2: value2 = operands16[op16Index]; break;
+                        case 4: value2 = operands32[op32Index]; break;
+                        case 8: value2 = operands64[op64Index]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op3Size) {
+                        case 1: addr = operands8[op8Index]; break;
+                        case 2: addr = operands16[op16Index]; break;
+                        case 4: addr = operands32[op32Index]; break;
+                        case 8: addr = operands64[op64Index]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op3Size) {
+                        case 1: addr = registers[operands8[op8Index]]; break;
+                        case 2: addr = registers[operands16[op16Index]]; break;
+                        case 4: addr = registers[operands32[op32Index]]; break;
+                        case 8: addr = registers[operands64[op64Index]]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+            }
+
+            if (value2 == 0) break;
+
+            if (getFlagBit(FLAG_DIRECTION)) {
+                dest = bulkLowEnd(dest, value2);
+            }
+
+            targetSpan = writableBytesSpan(dest, value2);
+            bulkFill(targetSpan.data(), value1 & 0xFF, value2);
+            break;
+
+        case 0x0142:
+            resetOpIndexes();
+
+            switch (op1Type) {
+                case reg:
+                    dest = operands8[op8Index++];
+                    break;
+
+                case mem_imm:
+                    switch (op1Size) {
+                        case 1: dest = operands8[op8Index++]; break;
+                        case 2: dest = operands16[op16Index++]; break;
+                        case 4: dest = operands32[op32Index++]; break;
+                        case 8: dest = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_reg:
+                    switch (op1Size) {
+                        case 1: dest = registers[operands8[op8Index++]]; break;
+                        case 2: dest = registers[operands16[op16Index++]]; break;
+                        case 4: dest = registers[operands32[op32Index++]]; break;
+                        case 8: dest = registers[operands64[op64Index++]]; break;
+                    }
+                    break;
+            }
+
+            switch (op2Type) {
+                case reg:
+                    value1 = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op2Size) {
+                        case 1: value1 = operands8[op8Index++]; break;
+                        case 2: value1 = operands16[op16Index++]; break;
+                        case 4: value1 = operands32[op32Index++]; break;
+                        case 8: value1 = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op2Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op2Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+            }
+
+            switch (op3Type) {
+                case reg:
+                    value2 = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op3Size) {
+                        case 1: value2 = operands8[op8Index++]; break;
+                        case 2: value2 = operands16[op16Index++]; break;
+                        case 4: value2 = operands32[op32Index++]; break;
+                        case 8: value2 = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op3Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op3Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+            }
+
+            switch (op4Type) {
+                case reg:
+                    value3 = registers[operands8[op8Index]];
+                    break;
+
+                case imm:
+                    switch (op4Size) {
+                        case 1: value3 = operands8[op8Index]; break;
+                        case 2: value3 = operands16[op16Index]; break;
+                        case 4: value3 = operands32[op32Index]; break;
+                        case 8: value3 = operands64[op64Index]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op4Size) {
+                        case 1: addr = operands8[op8Index]; break;
+                        case 2: addr = operands16[op16Index]; break;
+                        case 4: addr = operands32[op32Index]; break;
+                        case 8: addr = operands64[op64Index]; break;
+                    }
+
+                    value3 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op4Size) {
+                        case 1: addr = registers[operands8[op8Index]]; break;
+                        case 2: addr = registers[operands16[op16Index]]; break;
+                        case 4: addr = registers[operands32[op32Index]]; break;
+                        case 8: addr = registers[operands64[op64Index]]; break;
+                    }
+
+                    value3 = read64(addr);
+                    break;
+            }
+
+            if (value3 != 0 && getFlagBit(FLAG_DIRECTION)) {
+                value1 = bulkLowEnd(value1, value3);
+                value2 = bulkLowEnd(value2, value3);
+            }
+
+            sourceSpan = readBytesSpan(value1, value3);
+            sourceSpan2 = readBytesSpan(value2, value3);
+
+            value = bulkCompareRun(sourceSpan.data(), sourceSpan2.data(), value3, getFlagBit(FLAG_DIRECTION), below);
+
+            setFlagBit(FLAG_ZERO, value == value3);
+            setFlagBit(FLAG_CARRY, below);
+
+            switch (op1Type) {
+                case reg:
+                    registers[dest] = value;
+                    break;
+                case mem_imm:
+                case mem_reg:
+                    write64(dest, value);
+                    break;
+            }
+
+            break;
+
+        case 0x0143:
+            resetOpIndexes();
+
+            switch (op1Type) {
+                case reg:
+                    dest = operands8[op8Index++];
+                    break;
+
+                case mem_imm:
+                    switch (op1Size) {
+                        case 1: dest = operands8[op8Index++]; break;
+                        case 2: dest = operands16[op16Index++]; break;
+                        case 4: dest = operands32[op32Index++]; break;
+                        case 8: dest = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_reg:
+                    switch (op1Size) {
+                        case 1: dest = registers[operands8[op8Index++]]; break;
+                        case 2: dest = registers[operands16[op16Index++]]; break;
+                        case 4: dest = registers[operands32[op32Index++]]; break;
+                        case 8: dest = registers[operands64[op64Index++]]; break;
+                    }
+                    break;
+            }
+
+            switch (op2Type) {
+                case reg:
+                    value1 = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op2Size) {
+                        case 1: value1 = operands8[op8Index++]; break;
+                        case 2: value1 = operands16[op16Index++]; break;
+                        case 4: value1 = operands32[op32Index++]; break;
+                        case 8: value1 = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op2Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op2Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+            }
+
+            switch (op3Type) {
+                case reg:
+                    value2 = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op3Size) {
+                        case 1: value2 = operands8[op8Index++]; break;
+                        case 2: value2 = operands16[op16Index++]; break;
+                        case 4: value2 = operands32[op32Index++]; break;
+                        case 8: value2 = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op3Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op3Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+            }
+
+            switch (op4Type) {
+                case reg:
+                    value3 = registers[operands8[op8Index]];
+                    break;
+
+                case imm:
+                    switch (op4Size) {
+                        case 1: value3 = operands8[op8Index]; break;
+                        case 2: value3 = operands16[op16Index]; break;
+                        case 4: value3 = operands32[op32Index]; break;
+                        case 8: value3 = operands64[op64Index]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op4Size) {
+                        case 1: addr = operands8[op8Index]; break;
+                        case 2: addr = operands16[op16Index]; break;
+                        case 4: addr = operands32[op32Index]; break;
+                        case 8: addr = operands64[op64Index]; break;
+                    }
+
+                    value3 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op4Size) {
+                        case 1: addr = registers[operands8[op8Index]]; break;
+                        case 2: addr = registers[operands16[op16Index]]; break;
+                        case 4: addr = registers[operands32[op32Index]]; break;
+                        case 8: addr = registers[operands64[op64Index]]; break;
+                    }
+
+                    value3 = read64(addr);
+                    break;
+            }
+
+            if (value3 != 0 && getFlagBit(FLAG_DIRECTION)) {
+                value1 = bulkLowEnd(value1, value3);
+            }
+
+            sourceSpan = readBytesSpan(value1, value3);
+            hit = bulkFindRun(sourceSpan.data(), value2 & 0xFF, value3, getFlagBit(FLAG_DIRECTION));
+
+            setFlagBit(FLAG_ZERO, hit != value3);
+            value = hit != value3 ? value1 + hit : 0;
+
+            switch (op1Type) {
+                case reg:
+                    registers[dest] = value;
+                    break;
+                case mem_imm:
+                case mem_reg:
+                    write64(dest, value);
+                    break;
+            }
+
+            break;
+
+        case 0x013E:
+            resetOpIndexes();
+
+            switch (op1Type) {
+                case reg:
+                    dest = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op1Size) {
+                        case 1: dest = operands8[op8Index++]; break;
+                        case 2: dest = operands16[op16Index++]; break;
+                        case 4: dest = operands32[op32Index++]; break;
+                        case 8: dest = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op1Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    dest = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op1Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    dest = read64(addr);
+                    break;
+            }
+
+            switch (op2Type) {
+                case reg:
+                    value1 = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op2Size) {
+                        case 1: value1 = operands8[op8Index++]; break;
+                        case 2: value1 = operands16[op16Index++]; break;
+                        case 4: value1 = operands32[op32Index++]; break;
+                        case 8: value1 = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op2Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op2Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+            }
+
+            switch (op3Type) {
+                case reg:
+                    value2 = registers[operands8[op8Index]];
+                    break;
+
+                case imm:
+                    switch (op3Size) {
+                        case 1: value2 = operands8[op8Index]; break;
+                        case 2: value2 = operands16[op16Index]; break;
+                        case 4: value2 = operands32[op32Index]; break;
+                        case 8: value2 = operands64[op64Index]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op3Size) {
+                        case 1: addr = operands8[op8Index]; break;
+                        case 2: addr = operands16[op16Index]; break;
+                        case 4: addr = operands32[op32Index]; break;
+                        case 8: addr = operands64[op64Index]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op3Size) {
+                        case 1: addr = registers[operands8[op8Index]]; break;
+                        case 2: addr = registers[operands16[op16Index]]; break;
+                        case 4: addr = registers[operands32[op32Index]]; break;
+                        case 8: addr = registers[operands64[op64Index]]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+            }
+
+            if (value2 == 0) break;
+
+            targetSpan = writableBytesSpan(dest, value2);
+            motherboard->readPortBlock(static_cast<uint16_t>(value1), targetSpan.data(), value2);
+            break;
+
+        case 0x013F:
+            resetOpIndexes();
+
+            switch (op1Type) {
+                case reg:
+                    dest = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op1Size) {
+                        case 1: dest = operands8[op8Index++]; break;
+                        case 2: dest = operands16[op16Index++]; break;
+                        case 4: dest = operands32[op32Index++]; break;
+                        case 8: dest = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op1Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    dest = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op1Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    dest = read64(addr);
+                    break;
+            }
+
+            switch (op2Type) {
+                case reg:
+                    value1 = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op2Size) {
+                        case 1: value1 = operands8[op8Index++]; break;
+                        case 2: value1 = operands16[op16Index++]; break;
+                        case 4: value1 = operands32[op32Index++]; break;
+                        case 8: value1 = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op2Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op2Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+            }
+
+            switch (op3Type) {
+                case reg:
+                    value2 = registers[operands8[op8Index]];
+                    break;
+
+                case imm:
+                    switch (op3Size) {
+                        case 1: value2 = operands8[op8Index]; break;
+                        case 2: value2 = operands16[op16Index]; break;
+                        case 4: value2 = operands32[op32Index]; break;
+                        case 8: value2 = operands64[op64Index]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op3Size) {
+                        case 1: addr = operands8[op8Index]; break;
+                        case 2: addr = operands16[op16Index]; break;
+                        case 4: addr = operands32[op32Index]; break;
+                        case 8: addr = operands64[op64Index]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op3Size) {
+                        case 1: addr = registers[operands8[op8Index]]; break;
+                        case 2: addr = registers[operands16[op16Index]]; break;
+                        case 4: addr = registers[operands32[op32Index]]; break;
+                        case 8: addr = registers[operands64[op64Index]]; break;
+                    }
+
+                    value2 = read64(addr);
+                    break;
+            }
+
+            if (value2 == 0) break;
+
+            sourceSpan = readBytesSpan(value1, value2);
+            motherboard->writePortBlock(static_cast<uint16_t>(dest), sourceSpan.data(), value2);
+            break;
+
+        case 0x0200: case 0x0201: case 0x0202: case 0x0203:
+        case 0x0204: case 0x0205: case 0x0206: case 0x0207:
+        case 0x0208: case 0x0209: case 0x020A: case 0x020B:
+        case 0x020C: case 0x020D: case 0x020E: case 0x020F:
+        case 0x0210: case 0x0211: case 0x0212: case 0x0213:
+        case 0x0214: case 0x0215: case 0x0216: case 0x0217:
+        case 0x0218: case 0x0219: case 0x021A: case 0x021B:
+        case 0x021C: case 0x021D: case 0x021E: case 0x021F:
+            resetOpIndexes();
+
+            dest   = vectorRegister(op1Type, operands8[op8Index++]);
+            value1 = vectorRegister(op2Type, operands8[op8Index++]);
+            value2 = vectorRegister(op3Type, operands8[op8Index]);
+
+            vectorArithmetic((opcode & 0xFF) >> 2, 1 << (opcode & 0x03), vectorRegisters[dest], vectorRegisters[value1], vectorRegisters[value2]);
+
+            if (((opcode & 0xFF) >> 2) == VOP_CMPEQ) {
+                hit = 0;
+                for (int i = 0; i < VECTOR_BYTES; i += 8) {
+                    uint64_t lanes;
+                    std::memcpy(&lanes, vectorRegisters[dest] + i, 8);
+                    hit |= ~lanes;
+                }
+
+                setFlagBit(FLAG_ZERO, hit == 0);
+            }
+            break;
+
+        case 0x0220:
+            resetOpIndexes();
+
+            dest   = vectorRegister(op1Type, operands8[op8Index++]);
+            value1 = vectorRegister(op2Type, operands8[op8Index++]);
+            value2 = vectorRegister(op3Type, operands8[op8Index]);
+
+            vectorShuffle(vectorRegisters[dest], vectorRegisters[value1], vectorRegisters[value2]);
+            break;
+
+        case 0x0221:
+            resetOpIndexes();
+
+            dest = vectorRegister(op1Type, operands8[op8Index++]);
+
+            switch (op2Type) {
+                case reg:
+                    value1 = registers[operands8[op8Index]];
+                    break;
+
+                case imm:
+                    switch (op2Size) {
+                        case 1: value1 = operands8[op8Index]; break;
+                        case 2: value1 = operands16[op16Index]; break;
+                        case 4: value1 = operands32[op32Index]; break;
+                        case 8: value1 = operands64[op64Index]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op2Size) {
+                        case 1: addr = operands8[op8Index]; break;
+                        case 2: addr = operands16[op16Index]; break;
+                        case 4: addr = operands32[op32Index]; break;
+                        case 8: addr = operands64[op64Index]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op2Size) {
+                        case 1: addr = registers[operands8[op8Index]]; break;
+                        case 2: addr = registers[operands16[op16Index]]; break;
+                        case 4: addr = registers[operands32[op32Index]]; break;
+                        case 8: addr = registers[operands64[op64Index]]; break;
+                    }
+
+                    value1 = read64(addr);
+                    break;
+            }
+
+            sourceSpan = readBytesSpan(value1, VECTOR_BYTES);
+            std::memcpy(vectorRegisters[dest], sourceSpan.data(), VECTOR_BYTES);
+            break;
+
+        case 0x0222:
+            resetOpIndexes();
+
+            switch (op1Type) {
+                case reg:
+                    dest = registers[operands8[op8Index++]];
+                    break;
+
+                case imm:
+                    switch (op1Size) {
+                        case 1: dest = operands8[op8Index++]; break;
+                        case 2: dest = operands16[op16Index++]; break;
+                        case 4: dest = operands32[op32Index++]; break;
+                        case 8: dest = operands64[op64Index++]; break;
+                    }
+                    break;
+
+                case mem_imm:
+                    switch (op1Size) {
+                        case 1: addr = operands8[op8Index++]; break;
+                        case 2: addr = operands16[op16Index++]; break;
+                        case 4: addr = operands32[op32Index++]; break;
+                        case 8: addr = operands64[op64Index++]; break;
+                    }
+
+                    dest = read64(addr);
+                    break;
+
+                case mem_reg:
+                    switch (op1Size) {
+                        case 1: addr = registers[operands8[op8Index++]]; break;
+                        case 2: addr = registers[operands16[op16Index++]]; break;
+                        case 4: addr = registers[operands32[op32Index++]]; break;
+                        case 8: addr = registers[operands64[op64Index++]]; break;
+                    }
+
+                    dest = read64(addr);
+                    break;
+            }
+
+            value1 = vectorRegister(op2Type, operands8[op8Index]);
+
+            targetSpan = writableBytesSpan(dest, VECTOR_BYTES);
+            std::memcpy(targetSpan.data(), vectorRegisters[value1], VECTOR_BYTES);
+            break;
+
+        case 0xFD:
+        default:
+            running = false;
+            break;
+    }
+}
+
+uint8_t CPU::read8(uint64_t address) {
+    if (address >= Motherboard::ROM_START && address <= Motherboard::ROM_END) {
+        return rom->read8(address);
+    }
+
+    else if (address >= Motherboard::RAM_START && address <= Motherboard::RAM_END) {
+        return memory->read8(address);
+    }
+
+    else if (uint64_t value; motherboard->readMemoryMapped(address, 1, value)) {
+        return static_cast<uint8_t>(value);
+    }
+
+    else {
+        error("CP03AOOB", "Absolute address: " + std::to_string(address));
+        return 0;
+    }
+}
+
+uint16_t CPU::read16(uint64_t address) {
+    if (address >= Motherboard::ROM_START && address + 1 <= Motherboard::ROM_END) {
+        return rom->read16(address);
+    }
+    
+    else if (address >= Motherboard::RAM_START && address + 1 <= Motherboard::RAM_END) {
+        return memory->read16(address);
+    }
+    
+    else if (uint64_t value; motherboard->readMemoryMapped(address, 2, value)) {
+        return static_cast<uint16_t>(value);
+    }
+
+    else {
+        error("CP04AOOB", "Absolute address: " + std::to_string(address));
+        return 0;
+    }
+}
+
+uint32_t CPU::read32(uint64_t address) {
+    if (address >= Motherboard::ROM_START && address + 3 <= Motherboard::ROM_END) {
+        return rom->read32(address);
+    }
+    
+    else if (address >= Motherboard::RAM_START && address + 3 <= Motherboard::RAM_END) {
+        return memory->read32(address);
+    }
+    
+    else if (uint64_t value; motherboard->readMemoryMapped(address, 4, value)) {
+        return static_cast<uint32_t>(value);
+    }
+
+    else {
+        error("CP05AOOB", "Absolute address: " + std::to_string(address));
+        return 0;
+    }
+}
+
+uint64_t CPU::read64(uint64_t address) {
+    if (address >= Motherboard::ROM_START && address + 7 <= Motherboard::ROM_END) {
+        return rom->read64(address);
+    }
+    
+    else if (address >= Motherboard::RAM_START && address + 7 <= Motherboard::RAM_END) {
+        return memory->read64(address);
+    }
+    
+    else if (uint64_t value; motherboard->readMemoryMapped(address, 8, value)) {
+        return value;
+    }
+
+    else {
+        error("CP06AOOB", "Absolute address: " + std::to_string(address));
+        return 0;
+    }
+}
+
+std::vector<uint8_t> CPU::readBytesVector(uint64_t start, size_t length) {
+    if (start >= Motherboard::ROM_START && start + length - 1 <= Motherboard::ROM_END) {
+        return rom->readBytesVector(start, length);
+    }
+    
+    else if (start >= Motherboard::RAM_START && start + length - 1 <= Motherboard::RAM_END) {
+        return memory->readBytesVector(start, length);
+    }
+    
+    else {
+        error("CP07AOOB", "Absolute address: " + std::to_string(start));
+        return {0};
+    }
+}
+
+void CPU::write8(uint64_t address, uint8_t value) {
+    if (address >= Motherboard::ROM_START && address <= Motherboard::ROM_END) {
+        error("CP01CWTR", "Absolute address: " + std::to_string(address));
+    }
+    
+    else if (address >= Motherboard::RAM_START && address <= Motherboard::RAM_END) {
+        memory->write8(address, value);
+    }
+    
+    else if (!motherboard->writeMemoryMapped(address, value, 1)) {
+        error("CP08AOOB", "Absolute address: " + std::to_string(address));
+    }
+}
+
+void CPU::write16(uint64_t address, uint16_t value) {
+    if (address >= Motherboard::ROM_START && address + 1 <= Motherboard::ROM_END) {
+        error("CP01CWTR", "Absolute address: " + std::to_string(address));
+    }
+    
+    else if (address >= Motherboard::RAM_START && address + 1 <= Motherboard::RAM_END) {
+        memory->write16(address, value);
+    }
+    
+    else if (!motherboard->writeMemoryMapped(address, value, 2)) {
+        error("CP09AOOB", "Absolute address: " + std::to_string(address));
+    }
+}
+
+void CPU::write32(uint64_t address, uint32_t value) {
+    if (address >= Motherboard::ROM_START && address + 3 <= Motherboard::ROM_END) {
+        error("CP01CWTR", "Absolute address: " + std::to_string(address));
+    }
+    
+    else if (address >= Motherboard::RAM_START && address + 3 <= Motherboard::RAM_END) {
+        memory->write32(address, value);
+    }
+
+    else if (!motherboard->writeMemoryMapped(address, value, 4)) {
+        error("CP10AOOB", "Absolute address: " + std::to_string(address));
+    }
+}
+
+void CPU::write64(uint64_t address, uint64_t value) {
+    if (address >= Motherboard::ROM_START && address + 7 <= Motherboard::ROM_END) {
+        error("CP01CWTR", "Absolute address: " + std::to_string(address));
+    }
+    
+    else if (address >= Motherboard::RAM_START && address + 7 <= Motherboard::RAM_END) {
+        memory->write64(address, value);
+    }
+    
+    else if (!motherboard->writeMemoryMapped(address, value, 8)) {
+        error("CP11AOOB", "Absolute address: " + std::to_string(address));
+    }
+}
+
+void CPU::writeBytesVector(uint64_t start, const std::vector<uint8_t>& data) {
+    if (start >= Motherboard::ROM_START && start + data.size() - 1 <= Motherboard::ROM_END) {
+        error("CP02CWTR", "Absolute address: " + std::to_string(start));
+    }
+    
+    else if (start >= Motherboard::RAM_START && start + data.size() - 1 <= Motherboard::RAM_END) {
+        memory->writeBytesVector(start, data);
+    }
+    
+    else {
+        error("CP12AOOB", "Absolute address: " + std::to_string(start));
+    }
+}
+
+std::span<const uint8_t> CPU::readBytesSpan(uint64_t start, size_t length) {
+    if (length == 0) {
+        return {};
+    }
+
+    if (start >= Motherboard::ROM_START && start <= Motherboard::ROM_END && length - 1 <= Motherboard::ROM_END - start) {
+        return rom->readBytesSpan(start, length);
+    }
+
+    else if (start >= Motherboard::RAM_START && start <= Motherboard::RAM_END && length - 1 <= Motherboard::RAM_END - start) {
+        return memory->readBytesSpan(start, length);
+    }
+
+    else {
+        error("CP14AOOB", "Absolute address: " + std::to_string(start) + " + length (" + std::to_string(length) + ")");
+        return {};
+    }
+}
+
+std::span<uint8_t> CPU::writableBytesSpan(uint64_t start, size_t length) {
+    if (length == 0) {
+        return {};
+    }
+
+    if (start >= Motherboard::ROM_START && start <= Motherboard::ROM_END) {
+        error("CP15CWTR", "Absolute address: " + std::to_string(start));
+        return {};
+    }
+
+    else if (start >= Motherboard::RAM_START && start <= Motherboard::RAM_END && length - 1 <= Motherboard::RAM_END - start) {
+        return memory->writableBytesSpan(start, length);
+    }
+
+    else {
+        error("CP16AOOB", "Absolute address: " + std::to_string(start) + " + length (" + std::to_string(length) + ")");
+        return {};
+    }
+}
+
+uint8_t CPU::vectorRegister(OpType type, uint8_t index) const {
+    if (type != reg || index >= VECTOR_REGISTER_COUNT) {
+        error("CP17NEVR", "Vector register: " + std::to_string(index));
+    }
+
+    return index;
 }
 
 void CPU::error(std::string errorType, std::string info) const {
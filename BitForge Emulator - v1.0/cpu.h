@@ -9,6 +9,8 @@
 #include <Windows.h>
 #include <unordered_map>
 #include <atomic>
+#include <span>
+#include "vectorUnit.h"
 
 class Motherboard;
 class ROM;
@@ -28,6 +30,7 @@ struct CPU {
     uint64_t basePointer = 0;
     int instructionCounter = 0;
     uint64_t registers[64]{};
+    alignas(32) uint8_t vectorRegisters[VECTOR_REGISTER_COUNT][VECTOR_BYTES]{};
     uint8_t flags = 0;
 
     bool running = false;
@@ -37,6 +40,21 @@ struct CPU {
 
     Timer timer;
 
+    // sleepms/sleepsec set FLAG_SLEEP with a deadline instead of blocking the host thread,
+    // so interrupts are still taken (and end the sleep early, like wait).
+    bool sleepTimed = false;
+    uint64_t sleepDeadline = 0;   // guest microseconds
+
+    // Guest time follows the host clock from start(). With virtualTime it is the cycle count at
+    // Motherboard::VIRTUAL_CYCLES_PER_US instead, timer events run at exact cycles (nextEventCycle)
+    // and idle stretches are skipped.
+    bool virtualTime = false;
+    uint64_t nextEventCycle = UINT64_MAX;
+    std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+
+    uint64_t guestMicros() const;
+    void skipIdleTime();
+
     void triggerInterrupt(uint8_t vector);
     void checkInterrupts();
 
@@ -56,7 +74,7 @@ struct CPU {
     uint16_t operands16[4];
     uint32_t operands32[4];
     uint64_t operands64[4];
-    std::vector<std::vector<uint8_t>> operandsVector;
+    std::span<const uint8_t> operandSpan;
     uint8_t instructionSize;
 
     enum OpType {
@@ -96,14 +114,12 @@ struct CPU {
     int op16Index;
     int op32Index;
     int op64Index;
-    int opVectorIndex;
     
     inline void resetOpIndexes() {
         op8Index = 0;
         op16Index = 0;
         op32Index = 0;
         op64Index = 0;
-        opVectorIndex = 0;
     }
 
     uint64_t dest;
@@ -113,8 +129,11 @@ struct CPU {
     uint64_t value3;
     uint64_t addr;
     uint64_t sh;
-    std::vector<uint8_t>* VectorOfBytesPointer = nullptr;
-    std::vector<uint8_t> VectorOfBytes;
+    uint64_t hit;
+    bool below;
+    std::span<const uint8_t> sourceSpan;
+    std::span<const uint8_t> sourceSpan2;
+    std::span<uint8_t> targetSpan;
     int64_t result64;
     int64_t high64;
     uint64_t uhigh64;
@@ -123,6 +142,8 @@ struct CPU {
     uint64_t sum;
     unsigned char c_out;
 
+    // Set when the interrupt controller may have a vector to deliver; checkInterrupts asks it
+    // which one only then, so the per-instruction cost stays one atomic load.
     std::atomic<bool> pendingInterrupt = false;
     std::atomic<bool> pendingNMI = false;
     uint8_t interruptNumber = 0;
@@ -148,6 +169,11 @@ struct CPU {
     std::vector<uint8_t> readBytesVector(uint64_t start, size_t length);
     void writeBytesVector(uint64_t start, const std::vector<uint8_t>& data);
 
+    std::span<const uint8_t> readBytesSpan(uint64_t start, size_t length);
+    std::span<uint8_t> writableBytesSpan(uint64_t start, size_t length);
+
+    uint8_t vectorRegister(OpType type, uint8_t index) const;
+
     void start();
     void fetch();
     void decode();
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// A port mapped device. The motherboard hands it every in/out that falls completely inside
+// the port range it was attached to, with offset counted from the start of that range and
+// size 1, 2, 4 or 8 bytes (little endian).
+class Device {
+public:
+    virtual ~Device() = default;
+
+    virtual uint64_t readPort (uint16_t offset, int size) = 0;
+    virtual void     writePort(uint16_t offset, uint64_t value, int size) = 0;
+
+    // ins/outs: length bytes through the one port at offset, handed over in a single call.
+    // By default they go through readPort/writePort a byte at a time; a device with a data
+    // register overrides these to take the whole buffer at once.
+    virtual void readBlock(uint16_t offset, uint8_t* bytes, size_t length) {
+        for (size_t i = 0; i < length; i++) bytes[i] = static_cast<uint8_t>(readPort(offset, 1));
+    }
+
+    virtual void writeBlock(uint16_t offset, const uint8_t* bytes, size_t length) {
+        for (size_t i = 0; i < length; i++) writePort(offset, bytes[i], 1);
+    }
+
+    // Called when the CPU stops, before the register dump. Devices that buffer host output
+    // write it out here.
+    virtual void     flush() {}
+};
@@ -0,0 +1,35 @@
+#include "diskController.h"
+#include "motherboard.h"
+#include "storage.h"
+
+DiskController::DiskController(Motherboard* board) : QueuedController(board) {
+    start();
+}
+
+DiskController::~DiskController() {
+    stop();
+}
+
+bool DiskController::perform(uint8_t command, uint64_t diskAddress, uint64_t ramAddress, uint64_t length) {
+    if (command == DISK_CMD_BATCH)
+        return runDescriptors(ramAddress, length, DISK_CMD_BATCH);
+
+    return transfer(command, diskAddress, ramAddress, length);
+}
+
+bool DiskController::transfer(uint8_t command, uint64_t diskAddress, uint64_t ramAddress, uint64_t length) {
+    if (length == 0) return true;
+
+    if (!inRAM(ramAddress, length))
+        return false;
+
+    if (diskAddress + length > storage.disksize() || diskAddress + length < diskAddress)
+        return false;
+
+    switch (command) {
+        case DISK_CMD_TO_RAM:  storage.mvtram(diskAddress, ramAddress, length);  return true;
+        case DISK_CMD_TO_DISK: storage.mvtdisk(ramAddress, diskAddress, length); return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include "queuedController.h"
+
+static constexpr uint16_t DISK_REG_DISK_ADDRESS = QUEUE_REG_FIRST;
+static constexpr uint16_t DISK_REG_RAM_ADDRESS  = QUEUE_REG_SECOND;
+static constexpr uint16_t DISK_REG_LENGTH       = QUEUE_REG_LENGTH;
+static constexpr uint16_t DISK_REG_COMMAND      = QUEUE_REG_COMMAND;
+static constexpr uint16_t DISK_REG_VECTOR       = QUEUE_REG_VECTOR;
+static constexpr uint16_t DISK_REG_STATUS       = QUEUE_REG_STATUS;
+static constexpr uint16_t DISK_REG_QUEUED       = QUEUE_REG_QUEUED;
+static constexpr uint16_t DISK_REG_COMPLETED    = QUEUE_REG_COMPLETED;
+static constexpr uint16_t DISK_REG_COUNT        = QUEUE_REG_COUNT;
+
+static constexpr uint8_t DISK_CMD_NONE    = QUEUE_CMD_NONE;
+static constexpr uint8_t DISK_CMD_TO_RAM  = 0x01;
+static constexpr uint8_t DISK_CMD_TO_DISK = 0x02;
+static constexpr uint8_t DISK_CMD_BATCH   = 0x03;
+
+class DiskController : public QueuedController {
+public:
+    DiskController(Motherboard* board);
+    ~DiskController();
+
+    // Copies between disk and RAM on the calling thread after checking both ranges. The
+    // worker uses it for every request; the DMA controller's disk commands go through it too.
+    bool transfer(uint8_t command, uint64_t diskAddress, uint64_t ramAddress, uint64_t length);
+
+protected:
+    bool perform(uint8_t command, uint64_t diskAddress, uint64_t ramAddress, uint64_t length) override;
+};
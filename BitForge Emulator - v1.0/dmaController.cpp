@@ -0,0 +1,37 @@
+#include "dmaController.h"
+#include "diskController.h"
+#include "motherboard.h"
+#include <cstring>
+
+DMAController::DMAController(Motherboard* board) : QueuedController(board) {
+    start();
+}
+
+DMAController::~DMAController() {
+    stop();
+}
+
+// RAM to RAM is a host memmove over the RAM buffer. Disk copies are the disk controller's
+// transfer, run on this thread, so both devices check and move disk data the same way.
+bool DMAController::perform(uint8_t command, uint64_t source, uint64_t destination, uint64_t length) {
+    switch (command) {
+        case DMA_CMD_RAM_TO_RAM:
+            if (length == 0) return true;
+            if (!inRAM(source, length) || !inRAM(destination, length)) return false;
+            std::memmove(memory.memory.data() + (destination - Motherboard::RAM_START),
+                         memory.memory.data() + (source - Motherboard::RAM_START),
+                         length);
+            return true;
+
+        case DMA_CMD_DISK_TO_RAM:
+            return motherboard->diskController->transfer(DISK_CMD_TO_RAM, source, destination, length);
+
+        case DMA_CMD_RAM_TO_DISK:
+            return motherboard->diskController->transfer(DISK_CMD_TO_DISK, destination, source, length);
+
+        case DMA_CMD_GATHER:
+            return runDescriptors(source, length, DMA_CMD_GATHER);
+    }
+
+    return false;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include "queuedController.h"
+
+static constexpr uint16_t DMA_REG_SOURCE      = QUEUE_REG_FIRST;
+static constexpr uint16_t DMA_REG_DESTINATION = QUEUE_REG_SECOND;
+static constexpr uint16_t DMA_REG_LENGTH      = QUEUE_REG_LENGTH;
+static constexpr uint16_t DMA_REG_COMMAND     = QUEUE_REG_COMMAND;
+static constexpr uint16_t DMA_REG_VECTOR      = QUEUE_REG_VECTOR;
+static constexpr uint16_t DMA_REG_STATUS      = QUEUE_REG_STATUS;
+static constexpr uint16_t DMA_REG_QUEUED      = QUEUE_REG_QUEUED;
+static constexpr uint16_t DMA_REG_COMPLETED   = QUEUE_REG_COMPLETED;
+static constexpr uint16_t DMA_REG_COUNT       = QUEUE_REG_COUNT;
+
+static constexpr uint8_t DMA_CMD_NONE        = QUEUE_CMD_NONE;
+static constexpr uint8_t DMA_CMD_RAM_TO_RAM  = 0x01;
+static constexpr uint8_t DMA_CMD_DISK_TO_RAM = 0x02;
+static constexpr uint8_t DMA_CMD_RAM_TO_DISK = 0x03;
+static constexpr uint8_t DMA_CMD_GATHER      = 0x04;
+
+class DMAController : public QueuedController {
+public:
+    DMAController(Motherboard* board);
+    ~DMAController();
+
+protected:
+    bool perform(uint8_t command, uint64_t source, uint64_t destination, uint64_t length) override;
+};
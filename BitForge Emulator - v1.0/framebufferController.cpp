@@ -0,0 +1,148 @@
+#include "framebufferController.h"
+#include "motherboard.h"
+#include <cstring>
+#include <chrono>
+
+FramebufferController::FramebufferController(Motherboard* board) : motherboard(board) {
+    presenter = std::thread(&FramebufferController::run, this);
+}
+
+bool FramebufferController::share(const std::string& name) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    if (!mapping.create(name)) return !mapping.inUse;
+
+    FramebufferShared* shared = mapping.shared;
+    shared->width = width;
+    shared->height = height;
+    shared->geometry.fetch_add(1);
+    shared->magic.store(FB_MAGIC, std::memory_order_release);
+    return true;
+}
+
+FramebufferController::~FramebufferController() {
+    {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        stopping = true;
+    }
+    settingsChanged.notify_one();
+    if (presenter.joinable()) presenter.join();
+
+    if (mapping.shared) mapping.shared->magic.store(0, std::memory_order_release);
+}
+
+uint64_t FramebufferController::registerValue(uint16_t offset, int size) const {
+    uint64_t value = 0;
+    for (int i = 0; i < size && offset + i < FB_REG_COUNT; i++)
+        value |= static_cast<uint64_t>(registers[offset + i]) << (8 * i);
+    return value;
+}
+
+uint64_t FramebufferController::readPort(uint16_t offset, int size) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+
+    uint8_t status = 0;
+    if (lastFailed)     status |= FB_STATUS_ERROR;
+    if (mapping.shared) status |= FB_STATUS_SHARED;
+    registers[FB_REG_STATUS] = status;
+
+    uint64_t count = frames;
+    for (int i = 0; i < 8; i++) registers[FB_REG_FRAMES + i] = (count >> (8 * i)) & 0xFF;
+
+    return registerValue(offset, size);
+}
+
+void FramebufferController::writePort(uint16_t offset, uint64_t value, int size) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+
+    for (int i = 0; i < size && offset + i < FB_REG_COUNT; i++) {
+        uint16_t reg = offset + i;
+        if (reg >= FB_REG_STATUS) continue;
+        registers[reg] = (value >> (8 * i)) & 0xFF;
+    }
+
+    if (offset <= FB_REG_CONTROL && offset + size > FB_REG_CONTROL) configure();
+
+    if (offset > FB_REG_COMMAND || offset + size <= FB_REG_COMMAND) return;
+
+    uint8_t command = registers[FB_REG_COMMAND];
+    registers[FB_REG_COMMAND] = FB_CMD_NONE;
+
+    if (command == FB_CMD_PRESENT) publish(false);
+}
+
+// Writing control applies address, width and height. A buffer that does not fit in RAM sets
+// the error bit and leaves the framebuffer disabled.
+void FramebufferController::configure() {
+    uint8_t control = registers[FB_REG_CONTROL];
+    uint64_t newAddress = registerValue(FB_REG_ADDRESS, 8);
+    uint32_t newWidth   = static_cast<uint32_t>(registerValue(FB_REG_WIDTH, 2));
+    uint32_t newHeight  = static_cast<uint32_t>(registerValue(FB_REG_HEIGHT, 2));
+
+    lastFailed = false;
+    enabled = false;
+    autoPresent = (control & FB_CONTROL_AUTO) != 0;
+    if (!(control & FB_CONTROL_ENABLE)) return;
+
+    uint64_t bytes = static_cast<uint64_t>(newWidth) * newHeight;
+    if (newWidth == 0 || newHeight == 0 || newWidth > FB_MAX_WIDTH || newHeight > FB_MAX_HEIGHT ||
+        newAddress < Motherboard::RAM_START || newAddress + bytes - 1 > Motherboard::RAM_END || newAddress + bytes < newAddress) {
+        lastFailed = true;
+        return;
+    }
+
+    bool resized = newWidth != width || newHeight != height;
+    address = newAddress;
+    width = newWidth;
+    height = newHeight;
+    enabled = true;
+
+    if (FramebufferShared* shared = mapping.shared; shared && resized) {
+        shared->width = width;
+        shared->height = height;
+        shared->geometry.fetch_add(1, std::memory_order_release);
+    }
+
+    publish(true);
+    settingsChanged.notify_one();
+}
+
+// Copies the rows that differ from what the viewer has, and only marks those dirty. Comparing
+// against the shared copy catches every way the guest can write RAM (stores, mset/mcpy, DMA,
+// disk) without a hook in any of them. Called with publishMutex held.
+void FramebufferController::publish(bool everything) {
+    if (!enabled) return;
+
+    if (FramebufferShared* shared = mapping.shared) {
+        const uint8_t* source = memory.memory.data() + (address - Motherboard::RAM_START);
+
+        for (uint32_t y = 0; y < height; y++) {
+            const uint8_t* row = source + static_cast<size_t>(y) * width;
+            uint8_t* target = shared->pixels + static_cast<size_t>(y) * width;
+
+            if (!everything && std::memcmp(row, target, width) == 0) continue;
+
+            std::memcpy(target, row, width);
+            shared->dirty[y >> 6].fetch_or(1ull << (y & 63), std::memory_order_release);
+        }
+
+        shared->frames.fetch_add(1, std::memory_order_release);
+    }
+
+    frames++;
+}
+
+// Auto present: publishes every FB_AUTO_INTERVAL ms while enabled, so a guest that never sends
+// FB_CMD_PRESENT can still be watched.
+void FramebufferController::run() {
+    std::unique_lock<std::mutex> lock(publishMutex);
+
+    while (!stopping) {
+        if (enabled && autoPresent)
+            settingsChanged.wait_for(lock, std::chrono::milliseconds(FB_AUTO_INTERVAL), [this] { return stopping; });
+        else
+            settingsChanged.wait(lock, [this] { return stopping || (enabled && autoPresent); });
+
+        if (stopping) return;
+        if (enabled && autoPresent) publish(false);
+    }
+}
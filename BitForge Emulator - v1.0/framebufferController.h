@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include "device.h"
+#include "framebufferShared.h"
+
+class Motherboard;
+
+static constexpr uint16_t FB_REG_ADDRESS = 0x00;
+static constexpr uint16_t FB_REG_WIDTH   = 0x08;
+static constexpr uint16_t FB_REG_HEIGHT  = 0x0A;
+static constexpr uint16_t FB_REG_CONTROL = 0x0C;
+static constexpr uint16_t FB_REG_COMMAND = 0x0D;
+static constexpr uint16_t FB_REG_STATUS  = 0x0E;
+static constexpr uint16_t FB_REG_FRAMES  = 0x10;
+static constexpr uint16_t FB_REG_COUNT   = 0x18;
+
+static constexpr uint8_t FB_CONTROL_ENABLE = 1 << 0;
+static constexpr uint8_t FB_CONTROL_AUTO   = 1 << 1;
+
+static constexpr uint8_t FB_CMD_NONE    = 0x00;
+static constexpr uint8_t FB_CMD_PRESENT = 0x01;
+
+static constexpr uint8_t FB_STATUS_ERROR  = 1 << 0;
+static constexpr uint8_t FB_STATUS_SHARED = 1 << 1;
+
+static constexpr int FB_AUTO_INTERVAL = 16;   // ms
+
+class FramebufferController : public Device {
+public:
+    Motherboard* motherboard = nullptr;
+
+    FramebufferController(Motherboard* board);
+    ~FramebufferController();
+
+    // Creates the viewer's shared memory under name. False only when another emulator already
+    // has that name; a host without shared memory runs with the status bit clear.
+    bool share(const std::string& name);
+
+    uint64_t readPort (uint16_t offset, int size) override;
+    void     writePort(uint16_t offset, uint64_t value, int size) override;
+
+private:
+    uint8_t registers[FB_REG_COUNT]{};
+
+    FramebufferMapping mapping;
+
+    // Geometry in use, set from the registers when control is written.
+    uint64_t address = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool     enabled = false;
+    bool     autoPresent = false;
+
+    std::mutex               publishMutex;
+    std::condition_variable  settingsChanged;
+    std::thread              presenter;
+    bool                     stopping = false;
+    bool                     lastFailed = false;
+    std::atomic<uint64_t>    frames = 0;
+
+    uint64_t registerValue(uint16_t offset, int size) const;
+    void     configure();
+    void     publish(bool everything);
+    void     run();
+};
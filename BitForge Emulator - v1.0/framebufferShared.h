@@ -0,0 +1,151 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <string>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <cerrno>
+#endif
+
+// Shared between the emulator (FramebufferController) and the viewer (test.cpp), which maps the
+// same named memory to watch a running machine. Pixels are 8bpp RRRGGGBB, one row every width
+// bytes. The emulator copies rows that changed and sets their bit in dirty; the viewer takes
+// the bits with exchange(0) and uploads only those rows, so a row written while the viewer reads
+// it is simply marked dirty again.
+
+static constexpr uint32_t FB_MAX_WIDTH  = 1024;
+static constexpr uint32_t FB_MAX_HEIGHT = 768;
+static constexpr uint32_t FB_DIRTY_WORDS = FB_MAX_HEIGHT / 64;
+static constexpr uint32_t FB_MAGIC = 0x42464642;   // "BFFB"
+
+// Default segment name; computer.exe and viewer.exe take --framebuffer name to run several
+// machines side by side.
+static constexpr const char* FB_DEFAULT_NAME = "BitForgeFramebuffer";
+
+struct FramebufferShared {
+    std::atomic<uint32_t> magic;
+    std::atomic<uint32_t> owner;      // pid of the emulator that created it (POSIX)
+    std::atomic<uint32_t> width;
+    std::atomic<uint32_t> height;
+    std::atomic<uint32_t> geometry;   // bumped when width or height change
+    std::atomic<uint64_t> frames;     // bumped after every publish
+    std::atomic<uint64_t> dirty[FB_DIRTY_WORDS];
+    uint8_t pixels[FB_MAX_WIDTH * FB_MAX_HEIGHT];
+};
+
+class FramebufferMapping {
+public:
+    FramebufferShared* shared = nullptr;
+
+    // Set when create() failed because a running emulator already has the name.
+    bool inUse = false;
+
+    ~FramebufferMapping() { close(); }
+
+    // Emulator side: creates the mapping, never joins an existing one.
+    bool create(const std::string& name) { return owner = map(name, true); }
+
+    // Viewer side: fails while no emulator is running.
+    bool open(const std::string& name) { return map(name, false) && shared->magic.load(std::memory_order_acquire) == FB_MAGIC; }
+
+    void close() {
+        if (!shared) return;
+#ifdef _WIN32
+        UnmapViewOfFile(shared);
+        CloseHandle(handle);
+#else
+        munmap(shared, sizeof(FramebufferShared));
+        if (owner) shm_unlink(path.c_str());
+#endif
+        shared = nullptr;
+        owner = false;
+    }
+
+private:
+    bool owner = false;
+    std::string path;
+
+#ifdef _WIN32
+    HANDLE handle = nullptr;
+
+    bool map(const std::string& name, bool create) {
+        path = name;
+        handle = create
+            ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(FramebufferShared), path.c_str())
+            : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path.c_str());
+        if (!handle) return false;
+
+        if (create && GetLastError() == ERROR_ALREADY_EXISTS) {
+            inUse = true;
+            CloseHandle(handle);
+            return false;
+        }
+
+        shared = static_cast<FramebufferShared*>(MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(FramebufferShared)));
+        if (!shared) CloseHandle(handle);
+        return shared != nullptr;
+    }
+#else
+    bool map(const std::string& name, bool create) {
+        path = "/" + name;
+        int flags = create ? O_CREAT | O_EXCL | O_RDWR : O_RDWR;
+        int fd = shm_open(path.c_str(), flags, 0600);
+
+        // POSIX names outlive their process, so one left by an emulator that was killed or
+        // stopped through exit() is taken over instead of blocking every later run.
+        if (fd < 0 && create && errno == EEXIST && stale()) {
+            shm_unlink(path.c_str());
+            fd = shm_open(path.c_str(), flags, 0600);
+        }
+        if (fd < 0) {
+            inUse = create && errno == EEXIST;
+            return false;
+        }
+        if (create && ftruncate(fd, sizeof(FramebufferShared)) != 0) {
+            ::close(fd);
+            shm_unlink(path.c_str());
+            return false;
+        }
+
+        void* view = mmap(nullptr, sizeof(FramebufferShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            if (create) shm_unlink(path.c_str());
+            return false;
+        }
+
+        shared = static_cast<FramebufferShared*>(view);
+        if (create) shared->owner.store(static_cast<uint32_t>(getpid()), std::memory_order_release);
+        return true;
+    }
+
+    // True when the existing segment at path is not a framebuffer of this layout or its owner
+    // has exited.
+    bool stale() const {
+        int fd = shm_open(path.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size != static_cast<off_t>(sizeof(FramebufferShared))) {
+            ::close(fd);
+            return true;
+        }
+
+        void* view = mmap(nullptr, sizeof(FramebufferShared), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return false;
+
+        uint32_t pid = static_cast<const FramebufferShared*>(view)->owner.load(std::memory_order_acquire);
+        munmap(view, sizeof(FramebufferShared));
+        return pid != 0 && kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+    }
+#endif
+};
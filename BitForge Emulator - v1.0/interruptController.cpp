@@ -0,0 +1,104 @@
+#include "interruptController.h"
+#include <bit>
+
+InterruptController::InterruptController(std::atomic<bool>& hint) : hint(hint) {}
+
+// Device threads only set a pending bit and the CPU's pendingInterrupt hint, so raising
+// never waits on the CPU and two vectors raised back to back are both kept.
+void InterruptController::raise(uint8_t vector) {
+    pending[vector >> 6].fetch_or(1ull << (vector & 63), std::memory_order_release);
+    hint.store(true, std::memory_order_release);
+}
+
+int InterruptController::highest(const uint64_t* words) {
+    for (int w = ICU_VECTOR_WORDS - 1; w >= 0; w--)
+        if (words[w]) return w * 64 + 63 - std::countl_zero(words[w]);
+    return ICU_NO_VECTOR;
+}
+
+// The highest unmasked pending vector, if it is at or above the priority register and of a
+// higher class than every handler in service. Four words, one bit scan.
+int InterruptController::deliverable() const {
+    uint64_t ready[ICU_VECTOR_WORDS];
+    for (int w = 0; w < ICU_VECTOR_WORDS; w++) ready[w] = pending[w].load(std::memory_order_acquire) & ~mask[w];
+
+    int vector = highest(ready);
+    if (vector == ICU_NO_VECTOR || vector < priority) return ICU_NO_VECTOR;
+
+    int serviced = highest(inService);
+    if (serviced != ICU_NO_VECTOR && (vector >> 4) <= (serviced >> 4)) return ICU_NO_VECTOR;
+
+    return vector;
+}
+
+// Clears the hint before looking, so a vector raised during the scan sets it again instead
+// of being missed.
+void InterruptController::update() {
+    hint.store(false);
+    if (deliverable() != ICU_NO_VECTOR) hint.store(true);
+}
+
+int InterruptController::acknowledge() {
+    int vector = deliverable();
+
+    if (vector != ICU_NO_VECTOR) {
+        pending[vector >> 6].fetch_and(~(1ull << (vector & 63)), std::memory_order_acq_rel);
+        if (!(control & ICU_CONTROL_AUTO_EOI)) inService[vector >> 6] |= 1ull << (vector & 63);
+    }
+
+    update();
+    return vector;
+}
+
+void InterruptController::endOfInterrupt() {
+    int vector = highest(inService);
+    if (vector != ICU_NO_VECTOR) inService[vector >> 6] &= ~(1ull << (vector & 63));
+}
+
+uint64_t InterruptController::readPort(uint16_t offset, int size) {
+    uint8_t bytes[ICU_REG_COUNT]{};
+
+    for (int w = 0; w < ICU_VECTOR_WORDS; w++) {
+        uint64_t waiting = pending[w].load(std::memory_order_acquire);
+        for (int i = 0; i < 8; i++) {
+            bytes[ICU_REG_PENDING    + w * 8 + i] = (waiting      >> (8 * i)) & 0xFF;
+            bytes[ICU_REG_MASK       + w * 8 + i] = (mask[w]      >> (8 * i)) & 0xFF;
+            bytes[ICU_REG_IN_SERVICE + w * 8 + i] = (inService[w] >> (8 * i)) & 0xFF;
+        }
+    }
+    bytes[ICU_REG_PRIORITY] = priority;
+    bytes[ICU_REG_CONTROL]  = control;
+
+    uint64_t value = 0;
+    for (int i = 0; i < size && offset + i < ICU_REG_COUNT; i++)
+        value |= static_cast<uint64_t>(bytes[offset + i]) << (8 * i);
+    return value;
+}
+
+void InterruptController::writePort(uint16_t offset, uint64_t value, int size) {
+    for (int i = 0; i < size && offset + i < ICU_REG_COUNT; i++) {
+        uint16_t reg = offset + i;
+        uint64_t byte = (value >> (8 * i)) & 0xFF;
+
+        if (reg < ICU_REG_MASK) {
+            // Writing 1 bits drops those vectors without taking them.
+            int shift = 8 * ((reg - ICU_REG_PENDING) % 8);
+            pending[(reg - ICU_REG_PENDING) / 8].fetch_and(~(byte << shift), std::memory_order_acq_rel);
+        } else if (reg < ICU_REG_IN_SERVICE) {
+            uint64_t& word = mask[(reg - ICU_REG_MASK) / 8];
+            int shift = 8 * ((reg - ICU_REG_MASK) % 8);
+            word = (word & ~(0xFFull << shift)) | (byte << shift);
+        } else if (reg == ICU_REG_PRIORITY) {
+            priority = static_cast<uint8_t>(byte);
+        } else if (reg == ICU_REG_CONTROL) {
+            control = static_cast<uint8_t>(byte);
+        } else if (reg == ICU_REG_EOI) {
+            endOfInterrupt();
+        } else if (reg == ICU_REG_RAISE) {
+            raise(static_cast<uint8_t>(byte));
+        }
+    }
+
+    // A mask, priority or EOI change can let a waiting vector through.
+    update();
+}
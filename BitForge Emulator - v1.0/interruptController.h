@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "device.h"
+
+static constexpr uint16_t ICU_REG_PENDING    = 0x00;   // 32 bytes, one bit per vector
+static constexpr uint16_t ICU_REG_MASK       = 0x20;   // 32 bytes, 1 = masked
+static constexpr uint16_t ICU_REG_IN_SERVICE = 0x40;   // 32 bytes
+static constexpr uint16_t ICU_REG_PRIORITY   = 0x60;
+static constexpr uint16_t ICU_REG_CONTROL    = 0x61;
+static constexpr uint16_t ICU_REG_EOI        = 0x62;
+static constexpr uint16_t ICU_REG_RAISE      = 0x63;
+static constexpr uint16_t ICU_REG_COUNT      = 0x64;
+
+static constexpr uint8_t ICU_CONTROL_AUTO_EOI = 1 << 0;
+
+static constexpr int ICU_VECTOR_WORDS = 4;
+static constexpr int ICU_NO_VECTOR    = -1;
+
+// Vectors are prioritised by number: a higher vector is more urgent. They are grouped in
+// classes of 16 (vector >> 4) and a vector only interrupts a handler of a lower class.
+// hint is the CPU's pendingInterrupt flag; it is set whenever a vector may be deliverable.
+class InterruptController : public Device {
+public:
+    InterruptController(std::atomic<bool>& hint);
+
+    uint64_t readPort (uint16_t offset, int size) override;
+    void     writePort(uint16_t offset, uint64_t value, int size) override;
+
+    // Safe from any thread; never takes a lock.
+    void raise(uint8_t vector);
+
+    // CPU side. Returns the vector to take and marks it in service, or ICU_NO_VECTOR.
+    int  acknowledge();
+
+private:
+    std::atomic<bool>&    hint;
+    std::atomic<uint64_t> pending[ICU_VECTOR_WORDS]{};
+
+    // Only the CPU thread touches these (port I/O and acknowledge).
+    uint64_t mask[ICU_VECTOR_WORDS]{};
+    uint64_t inService[ICU_VECTOR_WORDS]{};
+    uint8_t  priority = 0;
+    uint8_t  control = 0;
+
+    static int highest(const uint64_t* words);
+    int  deliverable() const;
+    void endOfInterrupt();
+    void update();
+};
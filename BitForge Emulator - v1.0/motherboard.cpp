@@ -1,88 +1,273 @@
 #include "motherboard.h"
 #include "cpu.h"
+#include "diskController.h"
+#include "dmaController.h"
+#include "uartController.h"
+#include "pitController.h"
+#include "interruptController.h"
+#include "framebufferController.h"
+#include "channelController.h"
+#include "socketBridge.h"
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 
-Motherboard::Motherboard() {
+Motherboard::Motherboard(bool virtualTime) : virtualTime(virtualTime) {
     rom.loadFromFile("rom.bin");
 
     cpu = new CPU();
     cpu->motherboard = this;
+    cpu->virtualTime = virtualTime;
     cpu->rom = &rom;
     cpu->memory = &memory;
     cpu->instructionPointer = ROM_START;
     cpu->stackPointer = STACK_START;
     cpu->basePointer = STACK_START;
+
+    interruptController = new InterruptController(cpu->pendingInterrupt);
+    diskController = new DiskController(this);
+    dmaController = new DMAController(this);
+    uartController = new UARTController(*interruptController);
+    pitController = new PITController(this);
+    framebufferController = new FramebufferController(this);
+    channelController = new ChannelController(this);
+
+    attachDevice(diskController, DISK_PORT_START, DISK_PORT_END);
+    attachDevice(dmaController, DMA_PORT_START, DMA_PORT_END);
+    attachDevice(uartController, UART_PORT_START, UART_PORT_END);
+    attachDevice(pitController, PIT_PORT_START, PIT_PORT_END);
+    attachDevice(interruptController, ICU_PORT_START, ICU_PORT_END);
+    attachDevice(framebufferController, FB_PORT_START, FB_PORT_END);
+    attachDevice(channelController, CHANNEL_PORT_START, CHANNEL_PORT_END);
 }
 
 Motherboard::~Motherboard() {
+    delete socketBridge;
+    delete channelController;
+    delete framebufferController;
+    delete pitController;
+    delete uartController;
+    delete dmaController;
+    delete diskController;
+    delete interruptController;
     delete cpu;
 }
 
-uint8_t Motherboard::readPort8(uint16_t port) {
-    return ioPorts[port];
+void Motherboard::raiseInterrupt(uint8_t vector) {
+    interruptController->raise(vector);
 }
 
-uint16_t Motherboard::readPort16(uint16_t port) {
-    if (port > IO_PORT_COUNT - 2) {
-        return 0;
-    }
+// --socket path: bridges the channel device to a Unix domain socket.
+void Motherboard::startSocketBridge(const std::string& path) {
+    socketBridge = new SocketBridge(this, channelController, path);
+    if (!socketBridge->start())
+        error("MB03SKBF", "Socket path: " + path);
 
-    return static_cast<uint16_t>(ioPorts[port]) |
-        (static_cast<uint16_t>(ioPorts[port + 1]) << 8);
+    attachDevice(socketBridge, BRIDGE_PORT_START, BRIDGE_PORT_END);
 }
 
-uint32_t Motherboard::readPort32(uint16_t port) {
-    if (port > IO_PORT_COUNT - 4) {
-        return 0;
+// Publishes the framebuffer for viewer.exe under name. A name another emulator is using stops
+// the machine instead of both drawing into one segment.
+void Motherboard::shareFramebuffer(const std::string& name) {
+    if (!framebufferController->share(name))
+        error("MB06FBIU", "Framebuffer name: " + name);
+}
+
+// Virtual time: the CPU calls runEvents once its cycle count reaches the next timer event.
+void Motherboard::setNextEvent(uint64_t guestMicros) {
+    cpu->nextEventCycle = guestMicros == UINT64_MAX ? UINT64_MAX : guestMicros * VIRTUAL_CYCLES_PER_US;
+}
+
+void Motherboard::runEvents() {
+    pitController->runDue();
+}
+
+void Motherboard::error(std::string errorType, std::string info) const {
+    std::string returnString = "ERROR [" + errorType + "]";
+    if (info != "")
+        returnString += " - More info: " + info;
+    returnString += "\n\nFind out more in errorTypes.txt.\nStopping execution...";
+    std::cout << returnString;
+    std::cin.get();
+    exit(0);
+}
+
+void Motherboard::attachDevice(Device* device, uint16_t first, uint16_t last) {
+    if (last < first)
+        error("MB01PRIU", "Empty port range: " + std::to_string(first) + " - " + std::to_string(last));
+
+    for (uint32_t port = first; port <= last; port++)
+        if (portOwner[port])
+            error("MB01PRIU", "Port: " + std::to_string(port));
+
+    size_t index = 1;
+    while (index < PORT_RANGE_COUNT && portRanges[index].device) index++;
+    if (index == PORT_RANGE_COUNT)
+        error("MB02TMPR", "Ports: " + std::to_string(first) + " - " + std::to_string(last));
+
+    portRanges[index] = {device, first, last};
+    for (uint32_t port = first; port <= last; port++) portOwner[port] = static_cast<uint8_t>(index);
+
+    mapDevice(device, MMIO_START + first, MMIO_START + last);
+}
+
+void Motherboard::detachDevice(Device* device) {
+    for (size_t i = 1; i < PORT_RANGE_COUNT; i++) {
+        if (portRanges[i].device != device) continue;
+        for (uint32_t port = portRanges[i].first; port <= portRanges[i].last; port++) portOwner[port] = 0;
+        portRanges[i] = {};
     }
 
-    return static_cast<uint32_t>(ioPorts[port]) |
-        (static_cast<uint32_t>(ioPorts[port + 1]) << 8) |
-        (static_cast<uint32_t>(ioPorts[port + 2]) << 16) |
-        (static_cast<uint32_t>(ioPorts[port + 3]) << 24);
+    unmapDevice(device);
 }
 
-uint64_t Motherboard::readPort64(uint16_t port) {
-    if (port > IO_PORT_COUNT - 8) {
+// Regions are only changed while the CPU is not running (the constructor, startSocketBridge).
+void Motherboard::mapDevice(Device* device, uint64_t first, uint64_t last) {
+    if (first < MMIO_START || last < first || last - first >= MMIO_REGION_MAX)
+        error("MB04MMIO", "Addresses: " + std::to_string(first) + " - " + std::to_string(last));
+
+    if (mmioRegionCount == MMIO_REGION_COUNT)
+        error("MB05TMMR", "Addresses: " + std::to_string(first) + " - " + std::to_string(last));
+
+    MMIORegion* end = mmioRegions + mmioRegionCount;
+    MMIORegion* next = std::upper_bound(mmioRegions, end, first,
+        [](uint64_t address, const MMIORegion& region) { return address < region.first; });
+
+    if ((next != end && next->first <= last) || (next != mmioRegions && (next - 1)->last >= first))
+        error("MB04MMIO", "Addresses: " + std::to_string(first) + " - " + std::to_string(last));
+
+    std::move_backward(next, end, end + 1);
+    *next = {device, first, last};
+    mmioRegionCount++;
+}
+
+void Motherboard::unmapDevice(Device* device) {
+    MMIORegion* end = std::remove_if(mmioRegions, mmioRegions + mmioRegionCount,
+        [device](const MMIORegion& region) { return region.device == device; });
+    mmioRegionCount = end - mmioRegions;
+    std::fill(end, mmioRegions + MMIO_REGION_COUNT, MMIORegion{});
+}
+
+// The region holding all size bytes at address, or nullptr. An access that runs past the end
+// of a region is not split, it fails like any other unmapped address.
+const Motherboard::MMIORegion* Motherboard::findRegion(uint64_t address, int size) const {
+    if (address < MMIO_START || mmioRegionCount == 0) return nullptr;
+
+    const MMIORegion* end = mmioRegions + mmioRegionCount;
+    const MMIORegion* next = std::upper_bound(mmioRegions, end, address,
+        [](uint64_t address, const MMIORegion& region) { return address < region.first; });
+    if (next == mmioRegions) return nullptr;
+
+    const MMIORegion* region = next - 1;
+    if (address > region->last || static_cast<uint64_t>(size - 1) > region->last - address) return nullptr;
+    return region;
+}
+
+bool Motherboard::readMemoryMapped(uint64_t address, int size, uint64_t& value) {
+    const MMIORegion* region = findRegion(address, size);
+    if (!region) return false;
+
+    value = region->device->readPort(static_cast<uint16_t>(address - region->first), size);
+    return true;
+}
+
+bool Motherboard::writeMemoryMapped(uint64_t address, uint64_t value, int size) {
+    const MMIORegion* region = findRegion(address, size);
+    if (!region) return false;
+
+    region->device->writePort(static_cast<uint16_t>(address - region->first), value, size);
+    return true;
+}
+
+void Motherboard::flushDevices() {
+    for (size_t i = 1; i < PORT_RANGE_COUNT; i++)
+        if (portRanges[i].device) portRanges[i].device->flush();
+}
+
+// An access that is not completely inside one device range uses the port bytes, like before
+// the bus existed.
+uint64_t Motherboard::readPort(uint16_t port, int size) {
+    if (port > IO_PORT_COUNT - size) {
         return 0;
     }
 
-    return static_cast<uint64_t>(ioPorts[port]) |
-          (static_cast<uint64_t>(ioPorts[port + 1]) << 8) |
-          (static_cast<uint64_t>(ioPorts[port + 2]) << 16) |
-          (static_cast<uint64_t>(ioPorts[port + 3]) << 24) |
-          (static_cast<uint64_t>(ioPorts[port + 4]) << 32) |
-          (static_cast<uint64_t>(ioPorts[port + 5]) << 40) |
-          (static_cast<uint64_t>(ioPorts[port + 6]) << 48) |
-          (static_cast<uint64_t>(ioPorts[port + 7]) << 56);
-}
+    uint8_t owner = portOwner[port];
+    if (owner && portOwner[port + size - 1] == owner) {
+        const PortRange& range = portRanges[owner];
+        return range.device->readPort(port - range.first, size);
+    }
 
-void Motherboard::writePort8(uint16_t port, uint8_t value) {
-    ioPorts[port] = value;
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) value |= static_cast<uint64_t>(ioPorts[port + i]) << (8 * i);
+    return value;
 }
 
-void Motherboard::writePort16(uint16_t port, uint16_t value) {
-    if (port > IO_PORT_COUNT - 2) { 
+void Motherboard::writePort(uint16_t port, uint64_t value, int size) {
+    if (port > IO_PORT_COUNT - size) {
         return;
     }
 
-    for (int i = 0; i < 2; i++) ioPorts[port + i] = (value >> (8 * i)) & 0xFF;
+    uint8_t owner = portOwner[port];
+    if (owner && portOwner[port + size - 1] == owner) {
+        const PortRange& range = portRanges[owner];
+        range.device->writePort(port - range.first, value, size);
+        return;
+    }
+
+    for (int i = 0; i < size; i++) ioPorts[port + i] = (value >> (8 * i)) & 0xFF;
 }
 
-void Motherboard::writePort32(uint16_t port, uint32_t value) {
-    if (port > IO_PORT_COUNT - 4) {
+// ins/outs. A plain port reads as its byte every time and keeps the last byte written.
+void Motherboard::readPortBlock(uint16_t port, uint8_t* bytes, size_t length) {
+    if (uint8_t owner = portOwner[port]) {
+        const PortRange& range = portRanges[owner];
+        range.device->readBlock(port - range.first, bytes, length);
         return;
     }
 
-    for (int i = 0; i < 4; i++) ioPorts[port + i] = (value >> (8 * i)) & 0xFF;
+    std::memset(bytes, ioPorts[port], length);
 }
 
-void Motherboard::writePort64(uint16_t port, uint64_t value) {
-    if (port > IO_PORT_COUNT - 8) {
+void Motherboard::writePortBlock(uint16_t port, const uint8_t* bytes, size_t length) {
+    if (uint8_t owner = portOwner[port]) {
+        const PortRange& range = portRanges[owner];
+        range.device->writeBlock(port - range.first, bytes, length);
         return;
     }
-    
-    for (int i = 0; i < 8; i++) ioPorts[port + i] = (value >> (8 * i)) & 0xFF;
+
+    if (length > 0) ioPorts[port] = bytes[length - 1];
+}
+
+uint8_t Motherboard::readPort8(uint16_t port) {
+    return static_cast<uint8_t>(readPort(port, 1));
+}
+
+uint16_t Motherboard::readPort16(uint16_t port) {
+    return static_cast<uint16_t>(readPort(port, 2));
+}
+
+uint32_t Motherboard::readPort32(uint16_t port) {
+    return static_cast<uint32_t>(readPort(port, 4));
+}
+
+uint64_t Motherboard::readPort64(uint16_t port) {
+    return readPort(port, 8);
+}
+
+void Motherboard::writePort8(uint16_t port, uint8_t value) {
+    writePort(port, value, 1);
+}
+
+void Motherboard::writePort16(uint16_t port, uint16_t value) {
+    writePort(port, value, 2);
+}
+
+void Motherboard::writePort32(uint16_t port, uint32_t value) {
+    writePort(port, value, 4);
+}
+
+void Motherboard::writePort64(uint16_t port, uint64_t value) {
+    writePort(port, value, 8);
 }
 
 void Motherboard::run() {
@@ -1,8 +1,18 @@
 #pragma once
 #include "rom.h"
 #include "ram.h"
+#include "device.h"
+#include <string>
 
 class CPU;
+class DiskController;
+class DMAController;
+class UARTController;
+class PITController;
+class InterruptController;
+class FramebufferController;
+class ChannelController;
+class SocketBridge;
 
 extern RAM memory;
 extern ROM rom;
@@ -10,6 +20,14 @@ extern ROM rom;
 class Motherboard {
 public:
     CPU* cpu;
+    DiskController* diskController;
+    DMAController* dmaController;
+    UARTController* uartController;
+    PITController* pitController;
+    InterruptController* interruptController;
+    FramebufferController* framebufferController;
+    ChannelController* channelController;
+    SocketBridge* socketBridge = nullptr;
     
     static constexpr size_t RAM_SIZE = 128ull * 1024 * 1024;
     static constexpr size_t ROM_SIZE = 32ull * 1024;
@@ -34,9 +52,81 @@ public:
     static constexpr uint64_t RAM_USABLE_START = RAM_START;
     static constexpr uint64_t RAM_USABLE_END   = IVT_START - 1;
 
+    // --virtual-time: the guest runs at this many cycles per microsecond, whatever the host does.
+    static constexpr uint64_t VIRTUAL_CYCLES_PER_US = 100;
+    bool virtualTime = false;
+
     static constexpr uint32_t IO_PORT_COUNT = 65536;
     uint8_t ioPorts[IO_PORT_COUNT]{};
 
+    // Device bus. portOwner holds one byte per port with the index of the attached range that
+    // claims it, so dispatch is two array reads. 0 means unclaimed: the port keeps reading and
+    // writing ioPorts.
+    struct PortRange {
+        Device*  device = nullptr;
+        uint16_t first = 0;
+        uint16_t last = 0;
+    };
+
+    static constexpr size_t PORT_RANGE_COUNT = 256;
+    uint8_t   portOwner[IO_PORT_COUNT]{};
+    PortRange portRanges[PORT_RANGE_COUNT]{};
+
+    void attachDevice(Device* device, uint16_t first, uint16_t last);
+    void detachDevice(Device* device);
+    void flushDevices();
+
+    // Memory mapped I/O. Addresses from MMIO_START up are not memory: a CPU load or store that
+    // misses ROM and RAM is looked up here and handed to the device as a port access at
+    // address - first, so registers can be used with mval. Every attached port range is also
+    // mapped at MMIO_START + port. The table is kept sorted by address and binary searched,
+    // which only happens after the RAM check failed.
+    struct MMIORegion {
+        Device*  device = nullptr;
+        uint64_t first = 0;
+        uint64_t last = 0;
+    };
+
+    static constexpr uint64_t MMIO_START = 0x10000000;
+    static constexpr uint64_t MMIO_REGION_MAX = 0x10000;   // offsets are port offsets
+    static constexpr size_t   MMIO_WINDOW_COUNT = 64;      // mapDevice windows beyond the port aliases
+    static constexpr size_t   MMIO_REGION_COUNT = (PORT_RANGE_COUNT - 1) + MMIO_WINDOW_COUNT;
+    static_assert(MMIO_START > RAM_END);
+    static_assert(MMIO_REGION_COUNT >= PORT_RANGE_COUNT - 1, "every port range needs room for its MMIO alias");
+
+    MMIORegion mmioRegions[MMIO_REGION_COUNT]{};
+    size_t     mmioRegionCount = 0;
+
+    void mapDevice(Device* device, uint64_t first, uint64_t last);
+    void unmapDevice(Device* device);
+    const MMIORegion* findRegion(uint64_t address, int size) const;
+    bool readMemoryMapped (uint64_t address, int size, uint64_t& value);
+    bool writeMemoryMapped(uint64_t address, uint64_t value, int size);
+
+    static constexpr uint16_t DISK_PORT_START = 0x0100;
+    static constexpr uint16_t DISK_PORT_END   = 0x0127;
+
+    static constexpr uint16_t DMA_PORT_START  = 0x0140;
+    static constexpr uint16_t DMA_PORT_END    = 0x0167;
+
+    static constexpr uint16_t UART_PORT_START = 0x0180;
+    static constexpr uint16_t UART_PORT_END   = 0x01A7;
+
+    static constexpr uint16_t PIT_PORT_START  = 0x01C0;
+    static constexpr uint16_t PIT_PORT_END    = 0x01FF;
+
+    static constexpr uint16_t ICU_PORT_START  = 0x0200;
+    static constexpr uint16_t ICU_PORT_END    = 0x0263;
+
+    static constexpr uint16_t FB_PORT_START   = 0x0280;
+    static constexpr uint16_t FB_PORT_END     = 0x0297;
+
+    static constexpr uint16_t CHANNEL_PORT_START = 0x02A0;
+    static constexpr uint16_t CHANNEL_PORT_END   = 0x02DF;
+
+    static constexpr uint16_t BRIDGE_PORT_START  = 0x02E0;
+    static constexpr uint16_t BRIDGE_PORT_END    = 0x02F7;
+
     uint8_t  readPort8 (uint16_t port);
     uint16_t readPort16(uint16_t port);
     uint32_t readPort32(uint16_t port);
@@ -47,7 +137,19 @@ public:
     void writePort32(uint16_t port, uint32_t value);
     void writePort64(uint16_t port, uint64_t value);
 
-    Motherboard();
+    uint64_t readPort (uint16_t port, int size);
+    void     writePort(uint16_t port, uint64_t value, int size);
+
+    void readPortBlock (uint16_t port, uint8_t* bytes, size_t length);
+    void writePortBlock(uint16_t port, const uint8_t* bytes, size_t length);
+
+    void raiseInterrupt(uint8_t vector);
+    void startSocketBridge(const std::string& path);
+    void shareFramebuffer(const std::string& name);
+    void setNextEvent(uint64_t guestMicros);
+    void runEvents();
+    void error(std::string errorType, std::string info = "") const;
+    Motherboard(bool virtualTime = false);
     ~Motherboard();
     void run();
 };
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "pitController.h"
+#include "motherboard.h"
+#include "cpu.h"
+
+PITController::PITController(Motherboard* board) : motherboard(board) {
+    if (!motherboard->virtualTime) worker = std::thread(&PITController::run, this);
+}
+
+PITController::~PITController() {
+    {
+        std::lock_guard<std::mutex> lock(wheelMutex);
+        stopping = true;
+    }
+    wheelChanged.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+uint64_t PITController::currentTick() const {
+    if (motherboard->virtualTime) return motherboard->cpu->guestMicros() / PIT_TICK_US;
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime).count() / PIT_TICK_US;
+}
+
+uint64_t PITController::periodTicks(const Channel& channel) const {
+    uint64_t ticks = (channel.periodUs + PIT_TICK_US - 1) / PIT_TICK_US;
+    return ticks == 0 ? 1 : ticks;
+}
+
+uint64_t PITController::readPort(uint16_t offset, int size) {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+
+    uint8_t bytes[PIT_CHANNEL_STRIDE * PIT_CHANNEL_COUNT]{};
+    for (int c = 0; c < PIT_CHANNEL_COUNT; c++) {
+        Channel& channel = channels[c];
+        uint8_t* base = bytes + c * PIT_CHANNEL_STRIDE;
+
+        for (int i = 0; i < 8; i++) base[PIT_REG_PERIOD + i] = (channel.periodUs >> (8 * i)) & 0xFF;
+        for (int i = 0; i < 4; i++) base[PIT_REG_FIRED + i]  = (channel.fired >> (8 * i)) & 0xFF;
+        base[PIT_REG_VECTOR]  = channel.vector;
+        base[PIT_REG_CONTROL] = channel.control;
+        base[PIT_REG_STATUS]  = (channel.armed ? PIT_STATUS_ARMED : 0) | (channel.firedSinceRead ? PIT_STATUS_FIRED : 0);
+    }
+
+    uint64_t value = 0;
+    for (int i = 0; i < size && offset + i < PIT_CHANNEL_STRIDE * PIT_CHANNEL_COUNT; i++) {
+        uint16_t reg = offset + i;
+        value |= static_cast<uint64_t>(bytes[reg]) << (8 * i);
+
+        // Reading the status byte acknowledges the fired bit.
+        if (reg % PIT_CHANNEL_STRIDE == PIT_REG_STATUS) channels[reg / PIT_CHANNEL_STRIDE].firedSinceRead = false;
+    }
+
+    return value;
+}
+
+void PITController::writePort(uint16_t offset, uint64_t value, int size) {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+
+    bool controlWritten[PIT_CHANNEL_COUNT]{};
+
+    for (int i = 0; i < size && offset + i < PIT_CHANNEL_STRIDE * PIT_CHANNEL_COUNT; i++) {
+        uint16_t reg = offset + i;
+        Channel& channel = channels[reg / PIT_CHANNEL_STRIDE];
+        uint8_t byte = (value >> (8 * i)) & 0xFF;
+        uint16_t field = reg % PIT_CHANNEL_STRIDE;
+
+        if (field < PIT_REG_PERIOD + 8) {
+            channel.periodUs &= ~(0xFFull << (8 * field));
+            channel.periodUs |= static_cast<uint64_t>(byte) << (8 * field);
+        } else if (field == PIT_REG_VECTOR) {
+            channel.vector = byte;
+        } else if (field == PIT_REG_CONTROL) {
+            channel.control = byte;
+            controlWritten[reg / PIT_CHANNEL_STRIDE] = true;
+        }
+    }
+
+    // Writing control (re)starts the channel from now, or stops it when enable is clear.
+    for (int c = 0; c < PIT_CHANNEL_COUNT; c++)
+        if (controlWritten[c]) arm(c);
+}
+
+void PITController::arm(int index) {
+    Channel& channel = channels[index];
+
+    wheel.cancel(index);
+    channel.armed = false;
+    if (!(channel.control & PIT_CONTROL_ENABLE)) return publishNextEvent();
+
+    wheel.schedule(index, currentTick() + periodTicks(channel));
+    channel.armed = true;
+    wheelChanged.notify_one();
+    publishNextEvent();
+}
+
+void PITController::fire(uint32_t id, uint64_t dueTick) {
+    Channel& channel = channels[id];
+    channel.fired++;
+    channel.firedSinceRead = true;
+
+    if (channel.control & PIT_CONTROL_PERIODIC) wheel.schedule(id, dueTick + periodTicks(channel));
+    else channel.armed = false;
+
+    motherboard->raiseInterrupt(channel.vector);
+}
+
+void PITController::publishNextEvent() {
+    if (!motherboard->virtualTime) return;
+
+    uint64_t next = wheel.nextDue();
+    motherboard->setNextEvent(next == UINT64_MAX ? UINT64_MAX : next * PIT_TICK_US);
+}
+
+void PITController::runDue() {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+    wheel.advance(currentTick(), [this](uint32_t id, uint64_t dueTick) { fire(id, dueTick); });
+    publishNextEvent();
+}
+
+// One thread for every channel: sleeps until the earliest due tick, fires what is due and
+// schedules periodic channels one period after their previous due tick, so they do not drift.
+void PITController::run() {
+    std::unique_lock<std::mutex> lock(wheelMutex);
+
+    while (!stopping) {
+        uint64_t next = wheel.nextDue();
+
+        if (next == UINT64_MAX) wheelChanged.wait(lock);
+        else wheelChanged.wait_until(lock, startTime + std::chrono::microseconds(next * PIT_TICK_US));
+
+        if (stopping) return;
+
+        wheel.advance(currentTick(), [this](uint32_t id, uint64_t dueTick) { fire(id, dueTick); });
+    }
+}
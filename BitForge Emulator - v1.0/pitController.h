@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include "device.h"
+#include "timerWheel.h"
+
+class Motherboard;
+
+static constexpr int      PIT_CHANNEL_COUNT  = 4;
+static constexpr uint16_t PIT_CHANNEL_STRIDE = 0x10;
+
+static constexpr uint16_t PIT_REG_PERIOD  = 0x00;
+static constexpr uint16_t PIT_REG_VECTOR  = 0x08;
+static constexpr uint16_t PIT_REG_CONTROL = 0x09;
+static constexpr uint16_t PIT_REG_STATUS  = 0x0A;
+static constexpr uint16_t PIT_REG_FIRED   = 0x0C;
+
+static constexpr uint8_t PIT_CONTROL_ENABLE   = 1 << 0;
+static constexpr uint8_t PIT_CONTROL_PERIODIC = 1 << 1;
+
+static constexpr uint8_t PIT_STATUS_ARMED = 1 << 0;
+static constexpr uint8_t PIT_STATUS_FIRED = 1 << 1;
+
+static constexpr uint64_t PIT_TICK_US     = 100;
+static constexpr size_t   PIT_WHEEL_SLOTS = 1024;
+
+class PITController : public Device {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Motherboard* motherboard = nullptr;
+
+    PITController(Motherboard* board);
+    ~PITController();
+
+    uint64_t readPort (uint16_t offset, int size) override;
+    void     writePort(uint16_t offset, uint64_t value, int size) override;
+
+    // Virtual time: fires every channel due by now, on the CPU thread. There is no worker.
+    void runDue();
+
+private:
+    struct Channel {
+        uint64_t periodUs = 0;
+        uint8_t  vector = 0;
+        uint8_t  control = 0;
+        bool     armed = false;
+        bool     firedSinceRead = false;
+        uint32_t fired = 0;
+    };
+
+    Channel channels[PIT_CHANNEL_COUNT];
+
+    TimerWheel               wheel{PIT_WHEEL_SLOTS};
+    Clock::time_point        startTime = Clock::now();
+    std::mutex               wheelMutex;
+    std::condition_variable  wheelChanged;
+    std::thread              worker;
+    bool                     stopping = false;
+
+    uint64_t currentTick() const;
+    uint64_t periodTicks(const Channel& channel) const;
+    void     arm(int index);
+    void     fire(uint32_t id, uint64_t dueTick);
+    void     publishNextEvent();
+    void     run();
+};
@@ -0,0 +1,133 @@
+#include "queuedController.h"
+#include "motherboard.h"
+
+QueuedController::QueuedController(Motherboard* board) : motherboard(board) {}
+
+QueuedController::~QueuedController() {
+    stop();
+}
+
+void QueuedController::start() {
+    worker = std::thread(&QueuedController::run, this);
+}
+
+void QueuedController::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+bool QueuedController::inRAM(uint64_t address, uint64_t length) {
+    return address >= Motherboard::RAM_START &&
+           address + length >= address &&
+           address + length - 1 <= Motherboard::RAM_END;
+}
+
+uint64_t QueuedController::registerValue(uint16_t offset, int size) const {
+    uint64_t value = 0;
+    for (int i = 0; i < size && offset + i < QUEUE_REG_COUNT; i++)
+        value |= static_cast<uint64_t>(registers[offset + i]) << (8 * i);
+    return value;
+}
+
+uint64_t QueuedController::readPort(uint16_t offset, int size) {
+    size_t queued;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queued = queue.size();
+    }
+
+    uint8_t status = 0;
+    if (queued > 0 || inFlight)     status |= QUEUE_STATUS_BUSY;
+    if (lastFailed)                 status |= QUEUE_STATUS_ERROR;
+    if (queued >= QUEUE_DEPTH)      status |= QUEUE_STATUS_FULL;
+
+    registers[QUEUE_REG_STATUS] = status;
+    registers[QUEUE_REG_QUEUED] = static_cast<uint8_t>(queued);
+
+    uint64_t done = completed;
+    for (int i = 0; i < 8; i++)
+        registers[QUEUE_REG_COMPLETED + i] = (done >> (8 * i)) & 0xFF;
+
+    return registerValue(offset, size);
+}
+
+void QueuedController::writePort(uint16_t offset, uint64_t value, int size) {
+    for (int i = 0; i < size && offset + i < QUEUE_REG_COUNT; i++) {
+        uint16_t reg = offset + i;
+        if (reg == QUEUE_REG_STATUS || reg == QUEUE_REG_QUEUED || reg >= QUEUE_REG_COMPLETED) continue;
+        registers[reg] = (value >> (8 * i)) & 0xFF;
+    }
+
+    if (offset <= QUEUE_REG_COMMAND && offset + size > QUEUE_REG_COMMAND)
+        submit();
+}
+
+void QueuedController::submit() {
+    QueuedRequest request;
+    request.command = registers[QUEUE_REG_COMMAND];
+    request.first   = registerValue(QUEUE_REG_FIRST, 8);
+    request.second  = registerValue(QUEUE_REG_SECOND, 8);
+    request.length  = registerValue(QUEUE_REG_LENGTH, 8);
+    request.vector  = registers[QUEUE_REG_VECTOR];
+
+    registers[QUEUE_REG_COMMAND] = QUEUE_CMD_NONE;
+    if (request.command == QUEUE_CMD_NONE) return;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (queue.size() >= QUEUE_DEPTH) {
+            lastFailed = true;
+            return;
+        }
+        queue.push_back(request);
+    }
+    queueReady.notify_one();
+}
+
+void QueuedController::run() {
+    while (true) {
+        QueuedRequest request;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) return;
+
+            request = queue.front();
+            queue.pop_front();
+            inFlight = true;
+        }
+
+        bool ok = perform(request.command, request.first, request.second, request.length);
+
+        lastFailed = !ok;
+        completed++;
+        inFlight = false;
+
+        motherboard->raiseInterrupt(request.vector);
+    }
+}
+
+bool QueuedController::runDescriptors(uint64_t tableAddress, uint64_t count, uint8_t listCommand) {
+    if (count == 0) return true;
+
+    uint64_t tableSize = count * QUEUE_DESCRIPTOR_SIZE;
+    if (tableSize / QUEUE_DESCRIPTOR_SIZE != count || !inRAM(tableAddress, tableSize)) return false;
+
+    bool ok = true;
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t entry = tableAddress + i * QUEUE_DESCRIPTOR_SIZE;
+        uint8_t  command = static_cast<uint8_t>(memory.read64(entry));
+        uint64_t first   = memory.read64(entry + 8);
+        uint64_t second  = memory.read64(entry + 16);
+        uint64_t length  = memory.read64(entry + 24);
+
+        if (command == listCommand || !perform(command, first, second, length))
+            ok = false;
+    }
+
+    return ok;
+}
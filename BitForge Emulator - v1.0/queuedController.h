@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include "device.h"
+
+class Motherboard;
+
+// Register file shared by the disk and DMA controllers. The two address registers mean
+// disk/RAM address for the disk controller and source/destination for DMA.
+static constexpr uint16_t QUEUE_REG_FIRST     = 0x00;
+static constexpr uint16_t QUEUE_REG_SECOND    = 0x08;
+static constexpr uint16_t QUEUE_REG_LENGTH    = 0x10;
+static constexpr uint16_t QUEUE_REG_COMMAND   = 0x18;
+static constexpr uint16_t QUEUE_REG_VECTOR    = 0x19;
+static constexpr uint16_t QUEUE_REG_STATUS    = 0x1A;
+static constexpr uint16_t QUEUE_REG_QUEUED    = 0x1B;
+static constexpr uint16_t QUEUE_REG_COMPLETED = 0x20;
+static constexpr uint16_t QUEUE_REG_COUNT     = 0x28;
+
+static constexpr uint8_t QUEUE_CMD_NONE = 0x00;
+
+static constexpr uint8_t QUEUE_STATUS_BUSY  = 1 << 0;
+static constexpr uint8_t QUEUE_STATUS_ERROR = 1 << 1;
+static constexpr uint8_t QUEUE_STATUS_FULL  = 1 << 2;
+
+static constexpr size_t   QUEUE_DEPTH           = 64;
+static constexpr uint64_t QUEUE_DESCRIPTOR_SIZE = 32;
+
+struct QueuedRequest {
+    uint8_t  command;
+    uint64_t first;
+    uint64_t second;
+    uint64_t length;
+    uint8_t  vector;
+};
+
+// A device that takes requests through its registers, queues them and runs them one at a
+// time on its own worker thread, raising the request's vector when each one finishes.
+// Subclasses only say what a command does. They call start() at the end of their
+// constructor and stop() first thing in their destructor, so the worker never runs perform
+// on a half built or half destroyed object.
+class QueuedController : public Device {
+public:
+    Motherboard* motherboard = nullptr;
+
+    QueuedController(Motherboard* board);
+    ~QueuedController();
+
+    uint64_t readPort (uint16_t offset, int size) override;
+    void     writePort(uint16_t offset, uint64_t value, int size) override;
+
+protected:
+    void start();
+    void stop();
+
+    // Runs one command on the worker thread. False sets the error status bit.
+    virtual bool perform(uint8_t command, uint64_t first, uint64_t second, uint64_t length) = 0;
+
+    // Runs a table of count 32 byte descriptors (command, first, second, length) from RAM.
+    // Entries using listCommand fail instead of nesting.
+    bool runDescriptors(uint64_t tableAddress, uint64_t count, uint8_t listCommand);
+
+    static bool inRAM(uint64_t address, uint64_t length);
+
+private:
+    uint8_t registers[QUEUE_REG_COUNT]{};
+
+    std::deque<QueuedRequest> queue;
+    std::mutex                queueMutex;
+    std::condition_variable   queueReady;
+    std::thread               worker;
+    bool                      stopping = false;
+
+    std::atomic<bool>     inFlight = false;
+    std::atomic<bool>     lastFailed = false;
+    std::atomic<uint64_t> completed = 0;
+
+    uint64_t registerValue(uint16_t offset, int size) const;
+    void     submit();
+    void     run();
+};
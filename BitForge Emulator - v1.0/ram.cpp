@@ -75,6 +75,32 @@ std::vector<uint8_t> RAM::readBytesVector(uint64_t start, size_t length) {
     }
 }
 
+std::span<const uint8_t> RAM::readBytesSpan(uint64_t start, size_t length) {
+    uint64_t address = start - Motherboard::RAM_START;
+
+    if (length == 0) return {};
+
+    if (start < Motherboard::RAM_START || length > Motherboard::RAM_SIZE || address + length - 1 > Motherboard::RAM_SIZE - 1) {
+        error("RA11AOOB", "Absolute address: " + std::to_string(start) + " + length (" + std::to_string(length) + ")");
+        return {};
+    }
+
+    return std::span<const uint8_t>(memory.data() + address, length);
+}
+
+std::span<uint8_t> RAM::writableBytesSpan(uint64_t start, size_t length) {
+    uint64_t address = start - Motherboard::RAM_START;
+
+    if (length == 0) return {};
+
+    if (start < Motherboard::RAM_START || length > Motherboard::RAM_SIZE || address + length - 1 > Motherboard::RAM_SIZE - 1) {
+        error("RA12AOOB", "Absolute address: " + std::to_string(start) + " + length (" + std::to_string(length) + ")");
+        return {};
+    }
+
+    return std::span<uint8_t>(memory.data() + address, length);
+}
+
 void RAM::write8(uint64_t address, uint8_t value) {
     if (address < Motherboard::RAM_START || address > Motherboard::RAM_END) {
         error("RA06AOOB", "Absolute address: " + std::to_string(address));
@@ -4,6 +4,7 @@
 #include <string>
 #include <iostream>
 #include <cstdlib>
+#include <span>
 
 struct RAM {
     std::vector<uint8_t> memory;
@@ -30,6 +31,8 @@ struct RAM {
     uint64_t read64(uint64_t start);
 
     std::vector<uint8_t> readBytesVector(uint64_t start, size_t length);
+    std::span<const uint8_t> readBytesSpan(uint64_t start, size_t length);
+    std::span<uint8_t> writableBytesSpan(uint64_t start, size_t length);
 
     void write8(uint64_t address, uint8_t value);
     void write16(uint64_t address, uint16_t value);
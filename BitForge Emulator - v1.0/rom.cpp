@@ -31,7 +31,7 @@ uint8_t ROM::read8(uint64_t address) {
 uint16_t ROM::read16(uint64_t start) {
     uint64_t address = start - Motherboard::ROM_START;
 
-    if (start < Motherboard::ROM_START || address + 1 > Motherboard::ROM_SIZE - 1)
+    if (start < Motherboard::ROM_START || address > Motherboard::ROM_SIZE - 2)
         error("RO05AOOB", "Absolute address: " + std::to_string(start) + " + length (2)");
 
     return static_cast<uint16_t>(data[address]) |
@@ -41,7 +41,7 @@ uint16_t ROM::read16(uint64_t start) {
 uint32_t ROM::read32(uint64_t start) {
     uint64_t address = start - Motherboard::ROM_START;
 
-    if (start < Motherboard::ROM_START || address + 3 > Motherboard::ROM_SIZE - 1)
+    if (start < Motherboard::ROM_START || address > Motherboard::ROM_SIZE - 4)
         error("RO06AOOB", "Absolute address: " + std::to_string(start) + " + length (4)");
 
     return static_cast<uint32_t>(data[address]) |
@@ -53,7 +53,7 @@ uint32_t ROM::read32(uint64_t start) {
 uint64_t ROM::read64(uint64_t start) {
     uint64_t address = start - Motherboard::ROM_START;
 
-    if (start < Motherboard::ROM_START || address + 7 > Motherboard::ROM_SIZE - 1)
+    if (start < Motherboard::ROM_START || address > Motherboard::ROM_SIZE - 8)
         error("RO07AOOB", "Absolute address: " + std::to_string(start) + " + length (8)");
 
     return static_cast<uint64_t>(data[address]) |
@@ -69,7 +69,7 @@ uint64_t ROM::read64(uint64_t start) {
 std::vector<uint8_t> ROM::readBytesVector(uint64_t start, size_t length) {
     uint64_t address = start - Motherboard::ROM_START;
 
-    if (start < Motherboard::ROM_START || address + length - 1 > Motherboard::ROM_SIZE - 1) {
+    if (start < Motherboard::ROM_START || length > Motherboard::ROM_SIZE || address > Motherboard::ROM_SIZE - length) {
         error("RO08AOOB", "Absolute address: " + std::to_string(start) + " + length (" + std::to_string(length) + ")");
         return {0};
 
@@ -78,6 +78,19 @@ std::vector<uint8_t> ROM::readBytesVector(uint64_t start, size_t length) {
     }
 }
 
+std::span<const uint8_t> ROM::readBytesSpan(uint64_t start, size_t length) {
+    uint64_t address = start - Motherboard::ROM_START;
+
+    if (length == 0) return {};
+
+    if (start < Motherboard::ROM_START || length > Motherboard::ROM_SIZE || address > Motherboard::ROM_SIZE - length) {
+        error("RO09AOOB", "Absolute address: " + std::to_string(start) + " + length (" + std::to_string(length) + ")");
+        return {};
+    }
+
+    return std::span<const uint8_t>(data.data() + address, length);
+}
+
 void ROM::error(std::string errorType, std::string info) {
     if (!testing) {
         std::string returnString = "ERROR [" + errorType + "]";
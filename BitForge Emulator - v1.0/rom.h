@@ -5,6 +5,7 @@
 #include <iostream>
 #include <cstdint>
 #include <cstdlib>
+#include <span>
 
 class ROM {
     std::vector<uint8_t> data;
@@ -35,6 +36,7 @@ public:
     uint64_t read64(uint64_t address);
 
     std::vector<uint8_t> readBytesVector(uint64_t address, size_t length);
+    std::span<const uint8_t> readBytesSpan(uint64_t address, size_t length);
 };
 
 extern ROM rom;
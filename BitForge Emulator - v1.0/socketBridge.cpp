@@ -0,0 +1,288 @@
+#include "socketBridge.h"
+#include "motherboard.h"
+#include "channelController.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#endif
+
+#ifdef _WIN32
+static bool wouldBlock()                    { return WSAGetLastError() == WSAEWOULDBLOCK; }
+static void closeSocket(SocketHandle s)     { closesocket(s); }
+static void setNonBlocking(SocketHandle s)  { u_long on = 1; ioctlsocket(s, FIONBIO, &on); }
+static long recvSome(SocketHandle s, uint8_t* bytes, size_t length)       { return recv(s, reinterpret_cast<char*>(bytes), static_cast<int>(length), 0); }
+static long sendSome(SocketHandle s, const uint8_t* bytes, size_t length) { return send(s, reinterpret_cast<const char*>(bytes), static_cast<int>(length), 0); }
+#else
+static bool wouldBlock()                    { return errno == EAGAIN || errno == EWOULDBLOCK; }
+static void closeSocket(SocketHandle s)     { ::close(s); }
+static void setNonBlocking(SocketHandle s)  { fcntl(s, F_SETFL, fcntl(s, F_GETFL) | O_NONBLOCK); }
+static long recvSome(SocketHandle s, uint8_t* bytes, size_t length)       { return ::recv(s, bytes, length, 0); }
+static long sendSome(SocketHandle s, const uint8_t* bytes, size_t length) { return ::send(s, bytes, length, MSG_NOSIGNAL); }
+#endif
+
+SocketBridge::SocketBridge(Motherboard* board, ChannelController* channel, const std::string& path)
+    : motherboard(board), channel(channel), path(path) {}
+
+SocketBridge::~SocketBridge() {
+    channel->guestDoorbell = nullptr;
+
+    stopping = true;
+    wake();
+    if (loop.joinable()) loop.join();
+
+    closeClient();
+    if (listener != NO_SOCKET) {
+        closeSocket(listener);
+        std::remove(path.c_str());
+    }
+    closePoller();
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool SocketBridge::start() {
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) return false;
+#endif
+
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+
+    SocketHandle s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s == NO_SOCKET) return false;
+
+    // A socket file left behind by an earlier run would make bind fail.
+    std::remove(path.c_str());
+    if (bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(s, 4) != 0) {
+        closeSocket(s);
+        return false;
+    }
+
+    setNonBlocking(s);
+    listener = s;
+
+    if (!openPoller()) return false;
+    watch(listener, true, false, false);
+
+    channel->guestDoorbell = [this] { wake(); };
+    loop = std::thread(&SocketBridge::run, this);
+    return true;
+}
+
+uint64_t SocketBridge::readPort(uint16_t offset, int size) {
+    uint8_t bytes[BRIDGE_REG_COUNT]{};
+    bytes[BRIDGE_REG_STATUS] = (listener != NO_SOCKET ? BRIDGE_STATUS_LISTENING : 0) |
+                               (connected ? BRIDGE_STATUS_CONNECTED : 0);
+
+    uint64_t in = received, out = sent;
+    for (int i = 0; i < 8; i++) {
+        bytes[BRIDGE_REG_RECEIVED + i] = (in  >> (8 * i)) & 0xFF;
+        bytes[BRIDGE_REG_SENT + i]     = (out >> (8 * i)) & 0xFF;
+    }
+
+    uint64_t value = 0;
+    for (int i = 0; i < size && offset + i < BRIDGE_REG_COUNT; i++)
+        value |= static_cast<uint64_t>(bytes[offset + i]) << (8 * i);
+    return value;
+}
+
+void SocketBridge::writePort(uint16_t, uint64_t, int) {}
+
+void SocketBridge::acceptClient() {
+    SocketHandle s = accept(listener, nullptr, nullptr);
+    if (s == NO_SOCKET) return;
+
+    setNonBlocking(s);
+    client = s;
+    connected = true;
+    writeBlocked = false;
+
+    unwatch(listener);
+}
+
+void SocketBridge::closeClient() {
+    if (client == NO_SOCKET) return;
+
+    if (watchingRead || watchingWrite) unwatch(client);
+    watchingRead = watchingWrite = false;
+
+    closeSocket(client);
+    client = NO_SOCKET;
+    connected = false;
+
+    if (!stopping) watch(listener, true, false, false);
+}
+
+// Reads straight into the free part of the input ring until the socket is drained or the
+// ring is full. Every recv takes all the bytes that arrived so far, however many messages
+// that is, and inputProduced raises the ring's vector once for them.
+void SocketBridge::receive() {
+    while (client != NO_SOCKET) {
+        std::span<uint8_t> free = channel->inputWritable();
+        if (free.empty()) return;
+
+        long n = recvSome(client, free.data(), free.size());
+        if (n > 0) {
+            channel->inputProduced(static_cast<size_t>(n));
+            received += n;
+            continue;
+        }
+
+        if (n < 0 && wouldBlock()) return;
+        closeClient();
+    }
+}
+
+void SocketBridge::transmit() {
+    writeBlocked = false;
+
+    while (client != NO_SOCKET) {
+        std::span<const uint8_t> filled = channel->outputReadable();
+        if (filled.empty()) return;
+
+        long n = sendSome(client, filled.data(), filled.size());
+        if (n > 0) {
+            channel->outputConsumed(static_cast<size_t>(n));
+            sent += n;
+            continue;
+        }
+
+        if (n < 0 && wouldBlock()) {
+            writeBlocked = true;
+            return;
+        }
+        closeClient();
+    }
+}
+
+void SocketBridge::updateInterest() {
+    if (client == NO_SOCKET) return;
+
+    bool read = !channel->inputWritable().empty();
+    bool write = writeBlocked;
+    if (read == watchingRead && write == watchingWrite) return;
+
+    bool registered = watchingRead || watchingWrite;
+    if (!read && !write) unwatch(client);
+    else watch(client, read, write, registered);
+
+    watchingRead = read;
+    watchingWrite = write;
+}
+
+#ifdef _WIN32
+
+// Windows has no eventfd to wake WSAPoll with, so the loop polls with a short timeout and
+// picks up guest doorbells within POLL_INTERVAL ms.
+static constexpr int POLL_INTERVAL = 5;
+
+bool SocketBridge::openPoller() { return true; }
+void SocketBridge::closePoller() {}
+void SocketBridge::watch(SocketHandle, bool, bool, bool) {}
+void SocketBridge::unwatch(SocketHandle) {}
+void SocketBridge::wake() {}
+
+void SocketBridge::run() {
+    while (!stopping) {
+        WSAPOLLFD poll{};
+        if (client == NO_SOCKET) {
+            poll.fd = listener;
+            poll.events = POLLRDNORM;
+        } else {
+            poll.fd = client;
+            poll.events = (watchingRead ? POLLRDNORM : 0) | (watchingWrite ? POLLWRNORM : 0);
+        }
+
+        int ready = 0;
+        if (poll.events) ready = WSAPoll(&poll, 1, POLL_INTERVAL);
+        else Sleep(POLL_INTERVAL);
+        if (stopping) return;
+
+        if (ready > 0 && client == NO_SOCKET) acceptClient();
+
+        receive();
+        transmit();
+        updateInterest();
+    }
+}
+
+#else
+
+bool SocketBridge::openPoller() {
+    epollFd = epoll_create1(0);
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (epollFd < 0 || wakeFd < 0) return false;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) == 0;
+}
+
+void SocketBridge::closePoller() {
+    if (wakeFd >= 0) ::close(wakeFd);
+    if (epollFd >= 0) ::close(epollFd);
+    wakeFd = epollFd = -1;
+}
+
+void SocketBridge::watch(SocketHandle socket, bool read, bool write, bool modify) {
+    epoll_event event{};
+    event.events = (read ? static_cast<uint32_t>(EPOLLIN) : 0u) | (write ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.fd = socket;
+    epoll_ctl(epollFd, modify ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, socket, &event);
+}
+
+void SocketBridge::unwatch(SocketHandle socket) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+}
+
+// Called from the CPU thread when the guest moves an index: new output to send, or input
+// space to read into again.
+void SocketBridge::wake() {
+    if (wakeFd < 0) return;
+    uint64_t one = 1;
+    [[maybe_unused]] auto written = ::write(wakeFd, &one, sizeof(one));
+}
+
+void SocketBridge::run() {
+    epoll_event events[BRIDGE_MAX_EVENTS];
+
+    while (!stopping) {
+        int count = epoll_wait(epollFd, events, BRIDGE_MAX_EVENTS, -1);
+        if (stopping) return;
+
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+
+            if (fd == wakeFd) {
+                uint64_t wakeups;
+                [[maybe_unused]] auto read = ::read(wakeFd, &wakeups, sizeof(wakeups));
+            } else if (fd == listener && client == NO_SOCKET) {
+                acceptClient();
+            }
+        }
+
+        // Whatever woke the loop, move as much as the ring and the socket allow both ways.
+        receive();
+        transmit();
+        updateInterest();
+    }
+}
+
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <atomic>
+#include "device.h"
+
+class Motherboard;
+class ChannelController;
+
+#ifdef _WIN32
+using SocketHandle = uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+static constexpr SocketHandle NO_SOCKET = static_cast<SocketHandle>(-1);
+
+static constexpr uint16_t BRIDGE_REG_STATUS   = 0x00;
+static constexpr uint16_t BRIDGE_REG_RECEIVED = 0x08;
+static constexpr uint16_t BRIDGE_REG_SENT     = 0x10;
+static constexpr uint16_t BRIDGE_REG_COUNT    = 0x18;
+
+static constexpr uint8_t BRIDGE_STATUS_LISTENING = 1 << 0;
+static constexpr uint8_t BRIDGE_STATUS_CONNECTED = 1 << 1;
+
+static constexpr int BRIDGE_MAX_EVENTS = 16;
+
+// Connects the channel device to a Unix domain socket (computer.exe --socket path). Bytes a
+// client sends are received straight into the input ring, and whatever the guest puts in the
+// output ring is sent back, so a host process can drive a running guest. One client at a time;
+// the next one is accepted when it disconnects.
+//
+// One event loop thread (epoll, WSAPoll on Windows) does all socket work. A wakeup drains the
+// socket with as few recv calls as the ring allows, so many small messages become one ring
+// update and one interrupt. When the ring is full the bridge stops reading until the guest
+// moves its tail, and output waits in the ring while no client is connected.
+class SocketBridge : public Device {
+public:
+    Motherboard* motherboard = nullptr;
+
+    SocketBridge(Motherboard* board, ChannelController* channel, const std::string& path);
+    ~SocketBridge();
+
+    // Creates the socket and starts the event loop. False if the path cannot be bound.
+    bool start();
+
+    uint64_t readPort (uint16_t offset, int size) override;
+    void     writePort(uint16_t offset, uint64_t value, int size) override;
+
+private:
+    ChannelController* channel = nullptr;
+    std::string path;
+
+    SocketHandle listener = NO_SOCKET;
+    SocketHandle client = NO_SOCKET;
+
+    std::thread           loop;
+    std::atomic<bool>     stopping = false;
+    std::atomic<bool>     connected = false;
+    std::atomic<uint64_t> received = 0;
+    std::atomic<uint64_t> sent = 0;
+
+    // Interest currently registered for the client socket. A client with neither is taken
+    // off the poller, so a hangup cannot spin the loop while the input ring is full.
+    bool watchingRead = false;
+    bool watchingWrite = false;
+    bool writeBlocked = false;
+
+#ifndef _WIN32
+    int epollFd = -1;
+    int wakeFd = -1;
+#endif
+
+    void wake();
+    void run();
+    void acceptClient();
+    void closeClient();
+    void receive();
+    void transmit();
+    void updateInterest();
+
+    bool openPoller();
+    void closePoller();
+    void watch(SocketHandle socket, bool read, bool write, bool modify);
+    void unwatch(SocketHandle socket);
+};
@@ -27,6 +27,7 @@ Storage::~Storage() {
 
 void Storage::rawwrite(uint64_t offset, const void* src, uint64_t bytes) {
     if (offset + bytes > disk_size) return;
+    std::lock_guard<std::mutex> lock(diskMutex);
     disk.seekp(offset);
     disk.write(reinterpret_cast<const char*>(src), bytes);
     disk.flush();
@@ -35,6 +36,7 @@ void Storage::rawwrite(uint64_t offset, const void* src, uint64_t bytes) {
 uint64_t Storage::rawread(uint64_t offset, uint64_t bytes) {
     if (offset + bytes > disk_size) return 0;
     uint64_t value = 0;
+    std::lock_guard<std::mutex> lock(diskMutex);
     disk.seekg(offset);
     disk.read(reinterpret_cast<char*>(&value), bytes);
     return value;
@@ -42,11 +44,13 @@ uint64_t Storage::rawread(uint64_t offset, uint64_t bytes) {
 
 void Storage::loadFAT() {
     fat.resize(num_blocks);
+    std::lock_guard<std::mutex> lock(diskMutex);
     disk.seekg(fat_offset);
     disk.read(reinterpret_cast<char*>(fat.data()), num_blocks * 8);
 }
 
 void Storage::flushFAT() {
+    std::lock_guard<std::mutex> lock(diskMutex);
     disk.seekp(fat_offset);
     disk.write(reinterpret_cast<const char*>(fat.data()), num_blocks * 8);
     disk.flush();
@@ -85,8 +89,11 @@ bool Storage::findNameEntry(const std::string& name, uint64_t& nameOffset, uint6
     for (uint64_t i = 0; i < MAX_FILES; i++) {
         uint64_t offset = 8 + i * NAME_ENTRY_SIZE;
         char buf[64] = {};
-        disk.seekg(offset);
-        disk.read(buf, 64);
+        {
+            std::lock_guard<std::mutex> lock(diskMutex);
+            disk.seekg(offset);
+            disk.read(buf, 64);
+        }
         if (buf[0] == '\0') continue;
         if (std::string(buf, strnlen(buf, 64)) == name) {
             nameOffset = offset;
@@ -127,18 +134,21 @@ void Storage::writebytes32(uint64_t offset, uint32_t value) { rawwrite(offset, &
 void Storage::writebytes64(uint64_t offset, uint64_t value) { rawwrite(offset, &value, 8); }
 
 void Storage::mvtram(uint64_t disk_address, uint64_t ram_address, uint64_t length) {
-    if (disk_address + length > disk_size) return;
-    std::vector<uint8_t> buffer(length);
+    if (disk_address + length > disk_size || length == 0) return;
+    std::span<uint8_t> target = memory.writableBytesSpan(ram_address, length);
+    if (target.empty()) return;
+    std::lock_guard<std::mutex> lock(diskMutex);
     disk.seekg(disk_address);
-    disk.read(reinterpret_cast<char*>(buffer.data()), length);
-    memory.writeBytesVector(ram_address, buffer);
+    disk.read(reinterpret_cast<char*>(target.data()), length);
 }
 
 void Storage::mvtdisk(uint64_t ram_address, uint64_t disk_address, uint64_t length) {
-    if (disk_address + length > disk_size) return;
-    std::vector<uint8_t> buffer = memory.readBytesVector(ram_address, length);
+    if (disk_address + length > disk_size || length == 0) return;
+    std::span<const uint8_t> source = memory.readBytesSpan(ram_address, length);
+    if (source.empty()) return;
+    std::lock_guard<std::mutex> lock(diskMutex);
     disk.seekp(disk_address);
-    disk.write(reinterpret_cast<const char*>(buffer.data()), length);
+    disk.write(reinterpret_cast<const char*>(source.data()), length);
     disk.flush();
 }
 
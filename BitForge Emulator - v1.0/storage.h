@@ -4,6 +4,7 @@
 #include <string>
 #include <optional>
 #include <vector>
+#include <mutex>
 #include "ram.h"
 
 static constexpr uint64_t MAX_FILES        = 100000;
@@ -46,6 +47,7 @@ public:
 
 private:
     std::fstream         disk;
+    std::mutex           diskMutex;
     uint64_t             disk_size;
     uint64_t             num_blocks;
     uint64_t             fat_offset;
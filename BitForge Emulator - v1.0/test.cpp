@@ -2,41 +2,163 @@
 #include <SDL2/SDL.h>
 #include <fstream>
 #include <vector>
+#include <string>
 #include <cstdint>
+#include "framebufferShared.h"
 
-int main() {
-    std::ifstream f("rom.bin", std::ios::binary);
-    std::vector<uint8_t> rom(10000, 0);
-    if (f) f.read(reinterpret_cast<char*>(rom.data()), 10000);
+// viewer.exe                      watches the framebuffer of a running computer.exe
+// viewer.exe --framebuffer name   watches the one started with computer.exe --framebuffer name
+// viewer.exe rom.bin              shows the first 10000 bytes of a file as a 100x100 image
+
+static uint32_t palette[256];
+
+// RRRGGGBB to ARGB8888.
+static void buildPalette() {
+    for (int b = 0; b < 256; b++) {
+        uint32_t r  = ((b >> 5) & 0b111) * 36;
+        uint32_t g  = ((b >> 2) & 0b111) * 36;
+        uint32_t bl = (b & 0b11) * 85;
+        palette[b] = 0xFF000000 | (r << 16) | (g << 8) | bl;
+    }
+}
+
+struct Screen {
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture*  texture = nullptr;
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> converted;
+
+    void resize(int newWidth, int newHeight) {
+        if (texture) SDL_DestroyTexture(texture);
+        texture = nullptr;
+        width = newWidth;
+        height = newHeight;
+        if (width == 0 || height == 0) return;
+
+        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+        SDL_RenderSetLogicalSize(renderer, width, height);
+        converted.resize(static_cast<size_t>(width) * height);
+    }
+
+    // Converts and uploads rows first..first+count-1 with one texture update.
+    void upload(const uint8_t* pixels, int first, int count) {
+        uint32_t* out = converted.data() + static_cast<size_t>(first) * width;
+        const uint8_t* in = pixels + static_cast<size_t>(first) * width;
+        for (size_t i = 0; i < static_cast<size_t>(count) * width; i++) out[i] = palette[in[i]];
+
+        SDL_Rect rect = { 0, first, width, count };
+        SDL_UpdateTexture(texture, &rect, out, width * static_cast<int>(sizeof(uint32_t)));
+    }
+
+    // Uploads every run of dirty rows. Returns false when nothing was dirty.
+    bool uploadDirty(const uint8_t* pixels, const uint64_t* dirty) {
+        bool any = false;
+        int y = 0;
+        while (y < height) {
+            if (!(dirty[y >> 6] & (1ull << (y & 63)))) {
+                y++;
+                continue;
+            }
+
+            int first = y;
+            while (y < height && (dirty[y >> 6] & (1ull << (y & 63)))) y++;
+            upload(pixels, first, y - first);
+            any = true;
+        }
+        return any;
+    }
+
+    void present() {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        if (texture) SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+        SDL_RenderPresent(renderer);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    buildPalette();
 
     SDL_Init(SDL_INIT_VIDEO);
-    SDL_Window* window = SDL_CreateWindow("BitForge ROM Viewer", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1000, 1000, 0);
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, 0);
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+    SDL_Window* window = SDL_CreateWindow("BitForge Viewer", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1000, 1000, SDL_WINDOW_RESIZABLE);
+
+    Screen screen;
+    screen.renderer = SDL_CreateRenderer(window, -1, 0);
+
+    std::string framebufferName = FB_DEFAULT_NAME;
+    std::string filename;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--framebuffer" && i + 1 < argc) framebufferName = argv[++i];
+        else filename = arg;
+    }
+
+    // File mode: one upload, then only redrawn when the window needs it.
+    std::vector<uint8_t> file;
+    if (!filename.empty()) {
+        std::ifstream f(filename, std::ios::binary);
+        file.assign(10000, 0);
+        if (f) f.read(reinterpret_cast<char*>(file.data()), file.size());
+
+        screen.resize(100, 100);
+        screen.upload(file.data(), 0, 100);
+    }
+
+    FramebufferMapping mapping;
+    uint32_t seenGeometry = 0;
 
     bool running = true;
+    bool redraw = true;
     SDL_Event e;
     while (running) {
-        while (SDL_PollEvent(&e))
-            if (e.type == SDL_QUIT) running = false;
-
-        for (int y = 0; y < 100; y++) {
-            for (int x = 0; x < 100; x++) {
-                uint8_t b = rom[y * 100 + x];
-                uint8_t r = (b & 0b11100000) >> 5 * 36;
-                uint8_t g = (b & 0b00011100) >> 2 * 36;
-                uint8_t bl = (b & 0b00000011) * 85;
-                SDL_SetRenderDrawColor(renderer, r, g, bl, 255);
-                SDL_Rect rect = { x * 10, y * 10, 10, 10 };
-                SDL_RenderFillRect(renderer, &rect);
+        if (SDL_WaitEventTimeout(&e, 16)) {
+            do {
+                if (e.type == SDL_QUIT) running = false;
+                if (e.type == SDL_WINDOWEVENT) redraw = true;
+            } while (SDL_PollEvent(&e));
+        }
+
+        if (file.empty()) {
+            if (mapping.shared && mapping.shared->magic.load(std::memory_order_acquire) != FB_MAGIC) {
+                // The emulator stopped; keep the last frame and wait for the next run.
+                mapping.close();
+                seenGeometry = 0;
+            }
+
+            if (!mapping.shared && !mapping.open(framebufferName)) {
+                mapping.close();
+                SDL_Delay(250);
             }
         }
 
-        SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        if (FramebufferShared* shared = mapping.shared) {
+            uint32_t geometry = shared->geometry.load(std::memory_order_acquire);
+            uint64_t taken[FB_DIRTY_WORDS];
+
+            if (geometry != seenGeometry) {
+                seenGeometry = geometry;
+                screen.resize(shared->width, shared->height);
+                for (auto& word : taken) word = ~0ull;
+                for (auto& word : shared->dirty) word.store(0);
+                redraw = true;
+            } else {
+                for (uint32_t w = 0; w < FB_DIRTY_WORDS; w++) taken[w] = shared->dirty[w].exchange(0, std::memory_order_acquire);
+            }
+
+            if (screen.texture) redraw |= screen.uploadDirty(shared->pixels, taken);
+        }
+
+        if (redraw) {
+            screen.present();
+            redraw = false;
+        }
     }
 
-    SDL_DestroyRenderer(renderer);
+    screen.resize(0, 0);
+    SDL_DestroyRenderer(screen.renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <functional>
+
+// Hashed timing wheel. Time is counted in ticks; a timer due at tick t sits in slot
+// t % slotCount. Each id (a small index, the PIT channel) has at most one timer and its slot
+// is remembered, so schedule and cancel only touch one slot. Finding the next due timer
+// walks the slots ahead of now until it meets one, at most one turn of the wheel. The owner
+// calls advance with the current tick.
+class TimerWheel {
+public:
+    explicit TimerWheel(size_t slotCount) : slots(slotCount) {}
+
+    uint64_t now() const { return currentTick; }
+
+    // Replaces the id's timer, if it has one. Due ticks in the past fire on the next advance.
+    void schedule(uint32_t id, uint64_t dueTick) {
+        cancel(id);
+        if (dueTick <= currentTick) dueTick = currentTick + 1;
+
+        size_t slot = dueTick % slots.size();
+        slots[slot].push_back({id, dueTick});
+        if (id >= slotOf.size()) slotOf.resize(id + 1, NO_SLOT);
+        slotOf[id] = slot;
+        count++;
+    }
+
+    void cancel(uint32_t id) {
+        if (id >= slotOf.size() || slotOf[id] == NO_SLOT) return;
+
+        count -= std::erase_if(slots[slotOf[id]], [id](const Entry& e) { return e.id == id; });
+        slotOf[id] = NO_SLOT;
+    }
+
+    // Fires every timer due up to and including tick, in tick order. fire may schedule again.
+    void advance(uint64_t tick, const std::function<void(uint32_t id, uint64_t dueTick)>& fire) {
+        while (currentTick < tick) {
+            // Skip straight over empty ticks.
+            uint64_t next = nextDue();
+            if (next > tick) {
+                currentTick = tick;
+                return;
+            }
+
+            currentTick = next;
+            auto& slot = slots[currentTick % slots.size()];
+
+            for (size_t i = 0; i < slot.size();) {
+                if (slot[i].dueTick != currentTick) {
+                    i++;
+                    continue;
+                }
+
+                Entry due = slot[i];
+                slot[i] = slot.back();
+                slot.pop_back();
+                slotOf[due.id] = NO_SLOT;
+                count--;
+                fire(due.id, due.dueTick);
+            }
+        }
+    }
+
+    // Earliest due tick, or UINT64_MAX. Lets the owner sleep through empty stretches instead
+    // of waking every tick. Slots are walked in time order, so a timer due within one turn of
+    // the wheel ends the walk at its own slot; only timers further out cost a full turn.
+    uint64_t nextDue() const {
+        uint64_t next = UINT64_MAX;
+        if (count == 0) return next;
+
+        for (size_t i = 1; i <= slots.size(); i++) {
+            for (const auto& e : slots[(currentTick + i) % slots.size()]) {
+                if (e.dueTick == currentTick + i) return e.dueTick;
+                next = e.dueTick < next ? e.dueTick : next;
+            }
+        }
+        return next;
+    }
+
+private:
+    struct Entry {
+        uint32_t id;
+        uint64_t dueTick;
+    };
+
+    static constexpr size_t NO_SLOT = SIZE_MAX;
+
+    std::vector<std::vector<Entry>> slots;
+    std::vector<size_t> slotOf;     // by id
+    uint64_t currentTick = 0;
+    size_t count = 0;
+};
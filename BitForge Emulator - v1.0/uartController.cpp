@@ -0,0 +1,210 @@
+#include "uartController.h"
+#include "motherboard.h"
+#include "interruptController.h"
+#include <cstdio>
+#include <chrono>
+#include <algorithm>
+
+UARTController::UARTController(InterruptController& interrupts) : interrupts(interrupts) {
+    txPending.reserve(UART_TX_FIFO_SIZE);
+    txWriting.reserve(UART_TX_FIFO_SIZE);
+    flusher = std::thread(&UARTController::run, this);
+}
+
+UARTController::~UARTController() {
+    {
+        std::lock_guard<std::mutex> lock(txMutex);
+        stopping = true;
+    }
+    txReady.notify_one();
+    if (flusher.joinable()) flusher.join();
+}
+
+uint64_t UARTController::registerValue(uint16_t offset, int size) const {
+    uint64_t value = 0;
+    for (int i = 0; i < size && offset + i < UART_REG_COUNT; i++)
+        value |= static_cast<uint64_t>(registers[offset + i]) << (8 * i);
+    return value;
+}
+
+uint64_t UARTController::readPort(uint16_t offset, int size) {
+    uint8_t data = 0;
+    size_t waiting;
+    {
+        std::lock_guard<std::mutex> lock(rxMutex);
+        if (offset == UART_REG_DATA && !rxFifo.empty()) {
+            data = rxFifo.front();
+            rxFifo.pop_front();
+        }
+        waiting = rxFifo.size();
+    }
+
+    uint8_t status = 0;
+    {
+        std::lock_guard<std::mutex> lock(txMutex);
+        if (txPending.size() >= UART_TX_FIFO_SIZE)   status |= UART_STATUS_TX_FULL;
+        if (txPending.empty() && !writing)          status |= UART_STATUS_TX_EMPTY;
+    }
+    if (waiting > 0)    status |= UART_STATUS_RX_READY;
+    if (lastFailed)     status |= UART_STATUS_ERROR;
+    if (rxOverrun)      status |= UART_STATUS_RX_OVERRUN;
+
+    registers[UART_REG_DATA]   = data;
+    registers[UART_REG_STATUS] = status;
+
+    for (int i = 0; i < 4; i++)
+        registers[UART_REG_RX_COUNT + i] = (waiting >> (8 * i)) & 0xFF;
+
+    uint64_t sent = transmitted;
+    for (int i = 0; i < 8; i++)
+        registers[UART_REG_TRANSMITTED + i] = (sent >> (8 * i)) & 0xFF;
+
+    return registerValue(offset, size);
+}
+
+void UARTController::writePort(uint16_t offset, uint64_t value, int size) {
+    // Every byte written to the data register is sent, so out16-out64 send 2-8 characters.
+    if (offset == UART_REG_DATA) {
+        uint8_t bytes[8];
+        for (int i = 0; i < size; i++) bytes[i] = (value >> (8 * i)) & 0xFF;
+        transmit(bytes, size);
+        return;
+    }
+
+    for (int i = 0; i < size && offset + i < UART_REG_COUNT; i++) {
+        uint16_t reg = offset + i;
+        if (reg == UART_REG_STATUS || (reg >= UART_REG_RX_COUNT && reg < UART_REG_ADDRESS) || reg >= UART_REG_TRANSMITTED) continue;
+        registers[reg] = (value >> (8 * i)) & 0xFF;
+    }
+
+    rxControl.store(registers[UART_REG_CONTROL], std::memory_order_release);
+    rxVector.store(registers[UART_REG_VECTOR], std::memory_order_release);
+
+    if (offset <= UART_REG_STATUS && offset + size > UART_REG_STATUS) rxOverrun = false;
+
+    if (offset > UART_REG_COMMAND || offset + size <= UART_REG_COMMAND) return;
+
+    uint8_t command = registers[UART_REG_COMMAND];
+    registers[UART_REG_COMMAND] = UART_CMD_NONE;
+
+    switch (command) {
+        case UART_CMD_WRITE: writeBuffer(registerValue(UART_REG_ADDRESS, 8), registerValue(UART_REG_LENGTH, 8)); break;
+        case UART_CMD_FLUSH: flush(); break;
+    }
+}
+
+void UARTController::writeBlock(uint16_t offset, const uint8_t* bytes, size_t length) {
+    if (offset != UART_REG_DATA) return Device::writeBlock(offset, bytes, length);
+    transmit(bytes, length);
+}
+
+// Takes what the RX FIFO holds, up to length; the rest of the buffer reads as 0 like an empty
+// data register. RX_COUNT tells the guest how much is there.
+void UARTController::readBlock(uint16_t offset, uint8_t* bytes, size_t length) {
+    if (offset != UART_REG_DATA) return Device::readBlock(offset, bytes, length);
+
+    std::lock_guard<std::mutex> lock(rxMutex);
+    size_t count = std::min(length, rxFifo.size());
+    std::copy_n(rxFifo.begin(), count, bytes);
+    rxFifo.erase(rxFifo.begin(), rxFifo.begin() + count);
+    std::fill(bytes + count, bytes + length, 0);
+}
+
+// Copies into the TX FIFO. When it is full the caller waits for the flusher, so a guest that
+// prints faster than the host can write is slowed down instead of losing output.
+void UARTController::transmit(const uint8_t* bytes, size_t length) {
+    std::unique_lock<std::mutex> lock(txMutex);
+
+    while (length > 0) {
+        txDrained.wait(lock, [this] { return stopping || txPending.size() < UART_TX_FIFO_SIZE; });
+        if (stopping) return;
+
+        size_t part = std::min(length, UART_TX_FIFO_SIZE - txPending.size());
+        txPending.insert(txPending.end(), bytes, bytes + part);
+        bytes += part;
+        length -= part;
+        transmitted += part;
+
+        if (txPending.size() >= UART_FLUSH_BYTES) txReady.notify_one();
+    }
+}
+
+// UART_CMD_WRITE: sends length bytes straight from ROM or RAM, in one copy per FIFO fill.
+void UARTController::writeBuffer(uint64_t address, uint64_t length) {
+    lastFailed = false;
+    if (length == 0) return;
+
+    if (address + length < address) {
+        lastFailed = true;
+        return;
+    }
+
+    if (address + length - 1 <= Motherboard::ROM_END) {
+        transmit(rom.readBytesSpan(address, length).data(), length);
+        return;
+    }
+
+    if (address < Motherboard::RAM_START || address + length - 1 > Motherboard::RAM_END) {
+        lastFailed = true;
+        return;
+    }
+
+    transmit(memory.memory.data() + (address - Motherboard::RAM_START), length);
+}
+
+// Waits until everything queued so far has been written to the host.
+void UARTController::flush() {
+    std::unique_lock<std::mutex> lock(txMutex);
+    if (txPending.empty() && !writing) return;
+
+    flushRequested = true;
+    txReady.notify_one();
+    txDrained.wait(lock, [this] { return stopping || (txPending.empty() && !writing); });
+}
+
+void UARTController::receive(const uint8_t* bytes, size_t length) {
+    {
+        std::lock_guard<std::mutex> lock(rxMutex);
+        for (size_t i = 0; i < length; i++) {
+            if (rxFifo.size() >= UART_RX_FIFO_SIZE) {
+                rxOverrun = true;
+                break;
+            }
+            rxFifo.push_back(bytes[i]);
+        }
+    }
+
+    if (length > 0 && (rxControl.load(std::memory_order_acquire) & UART_CONTROL_RX_INTERRUPT))
+        interrupts.raise(rxVector.load(std::memory_order_acquire));
+}
+
+// Wakes when enough output is queued, a flush is asked for or the interval passes, and writes
+// the whole batch with one call while the CPU keeps filling the other buffer.
+void UARTController::run() {
+    std::unique_lock<std::mutex> lock(txMutex);
+
+    while (true) {
+        txReady.wait_for(lock, std::chrono::milliseconds(UART_FLUSH_INTERVAL), [this] {
+            return stopping || flushRequested || txPending.size() >= UART_FLUSH_BYTES;
+        });
+
+        if (!txPending.empty()) {
+            txWriting.swap(txPending);
+            writing = true;
+            txDrained.notify_all();
+
+            lock.unlock();
+            std::fwrite(txWriting.data(), 1, txWriting.size(), stdout);
+            std::fflush(stdout);
+            txWriting.clear();
+            lock.lock();
+
+            writing = false;
+        }
+
+        if (txPending.empty()) flushRequested = false;
+        txDrained.notify_all();
+
+        if (stopping && txPending.empty()) return;
+    }
+}
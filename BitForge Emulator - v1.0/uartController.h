@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include "device.h"
+
+class InterruptController;
+
+static constexpr uint16_t UART_REG_DATA        = 0x00;
+static constexpr uint16_t UART_REG_STATUS      = 0x01;
+static constexpr uint16_t UART_REG_CONTROL     = 0x02;
+static constexpr uint16_t UART_REG_VECTOR      = 0x03;
+static constexpr uint16_t UART_REG_RX_COUNT    = 0x04;
+static constexpr uint16_t UART_REG_ADDRESS     = 0x08;
+static constexpr uint16_t UART_REG_LENGTH      = 0x10;
+static constexpr uint16_t UART_REG_COMMAND     = 0x18;
+static constexpr uint16_t UART_REG_TRANSMITTED = 0x20;
+static constexpr uint16_t UART_REG_COUNT       = 0x28;
+
+static constexpr uint8_t UART_CMD_NONE  = 0x00;
+static constexpr uint8_t UART_CMD_WRITE = 0x01;
+static constexpr uint8_t UART_CMD_FLUSH = 0x02;
+
+static constexpr uint8_t UART_STATUS_RX_READY   = 1 << 0;
+static constexpr uint8_t UART_STATUS_TX_FULL    = 1 << 1;
+static constexpr uint8_t UART_STATUS_TX_EMPTY   = 1 << 2;
+static constexpr uint8_t UART_STATUS_ERROR      = 1 << 3;
+static constexpr uint8_t UART_STATUS_RX_OVERRUN = 1 << 4;
+
+static constexpr uint8_t UART_CONTROL_RX_INTERRUPT = 1 << 0;
+
+static constexpr size_t UART_TX_FIFO_SIZE   = 64 * 1024;
+static constexpr size_t UART_RX_FIFO_SIZE   = 4 * 1024;
+static constexpr size_t UART_FLUSH_BYTES    = 16 * 1024;
+static constexpr int    UART_FLUSH_INTERVAL = 10;   // ms
+
+class UARTController : public Device {
+public:
+    InterruptController& interrupts;
+
+    UARTController(InterruptController& interrupts);
+    ~UARTController();
+
+    uint64_t readPort (uint16_t offset, int size) override;
+    void     writePort(uint16_t offset, uint64_t value, int size) override;
+    void     flush() override;
+
+    // ins/outs on the data register move the whole buffer with one FIFO operation.
+    void     readBlock (uint16_t offset, uint8_t* bytes, size_t length) override;
+    void     writeBlock(uint16_t offset, const uint8_t* bytes, size_t length) override;
+
+    // Host side of RX: queues bytes for the guest and raises the RX interrupt if enabled.
+    // Safe from any thread.
+    void receive(const uint8_t* bytes, size_t length);
+
+private:
+    uint8_t registers[UART_REG_COUNT]{};
+
+    // Copies of CONTROL and VECTOR for receive(), which runs on a host thread while the CPU
+    // thread owns registers.
+    std::atomic<uint8_t> rxControl = 0;
+    std::atomic<uint8_t> rxVector = 0;
+
+    std::vector<uint8_t>     txPending;
+    std::vector<uint8_t>     txWriting;
+    std::mutex               txMutex;
+    std::condition_variable  txReady;
+    std::condition_variable  txDrained;
+    std::thread              flusher;
+    bool                     stopping = false;
+    bool                     flushRequested = false;
+    bool                     writing = false;
+
+    std::deque<uint8_t>   rxFifo;
+    std::mutex            rxMutex;
+    std::atomic<bool>     rxOverrun = false;
+
+    std::atomic<bool>     lastFailed = false;
+    std::atomic<uint64_t> transmitted = 0;
+
+    uint64_t registerValue(uint16_t offset, int size) const;
+    void     transmit(const uint8_t* bytes, size_t length);
+    void     writeBuffer(uint64_t address, uint64_t length);
+    void     run();
+};
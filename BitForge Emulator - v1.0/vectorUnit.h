@@ -0,0 +1,243 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <immintrin.h>
+
+// Host side of the 0x02 vector extension. Each vector register is 256 bits and is
+// processed as 32 x 8, 16 x 16, 8 x 32 or 4 x 64 bit lanes. AVX2 hosts do a register in
+// one instruction, SSE hosts in two 128 bit halves, and anything the host lacks runs scalar.
+
+static constexpr int VECTOR_REGISTER_COUNT = 32;
+static constexpr int VECTOR_BYTES          = 32;
+
+enum VectorOp : uint8_t {
+    VOP_ADD   = 0,
+    VOP_SUB   = 1,
+    VOP_MUL   = 2,
+    VOP_UMIN  = 3,
+    VOP_UMAX  = 4,
+    VOP_SMIN  = 5,
+    VOP_SMAX  = 6,
+    VOP_CMPEQ = 7
+};
+
+template <typename T, typename S>
+inline void vectorLanes(uint8_t op, uint8_t* d, const uint8_t* a, const uint8_t* b) {
+    for (int i = 0; i < VECTOR_BYTES; i += sizeof(T)) {
+        T x, y, r = 0;
+        std::memcpy(&x, a + i, sizeof(T));
+        std::memcpy(&y, b + i, sizeof(T));
+
+        switch (op) {
+            case VOP_ADD:   r = static_cast<T>(x + y); break;
+            case VOP_SUB:   r = static_cast<T>(x - y); break;
+            case VOP_MUL:   r = static_cast<T>(x * y); break;
+            case VOP_UMIN:  r = x < y ? x : y; break;
+            case VOP_UMAX:  r = x > y ? x : y; break;
+            case VOP_SMIN:  r = static_cast<S>(x) < static_cast<S>(y) ? x : y; break;
+            case VOP_SMAX:  r = static_cast<S>(x) > static_cast<S>(y) ? x : y; break;
+            case VOP_CMPEQ: r = x == y ? static_cast<T>(~T(0)) : T(0); break;
+        }
+
+        std::memcpy(d + i, &r, sizeof(T));
+    }
+}
+
+inline void vectorLanesScalar(uint8_t op, int laneBytes, uint8_t* d, const uint8_t* a, const uint8_t* b) {
+    switch (laneBytes) {
+        case 1: vectorLanes<uint8_t,  int8_t >(op, d, a, b); break;
+        case 2: vectorLanes<uint16_t, int16_t>(op, d, a, b); break;
+        case 4: vectorLanes<uint32_t, int32_t>(op, d, a, b); break;
+        case 8: vectorLanes<uint64_t, int64_t>(op, d, a, b); break;
+    }
+}
+
+#if defined(__AVX2__)
+
+inline __m256i vectorMul8(__m256i x, __m256i y) {
+    __m256i even = _mm256_mullo_epi16(x, y);
+    __m256i odd  = _mm256_mullo_epi16(_mm256_srli_epi16(x, 8), _mm256_srli_epi16(y, 8));
+    return _mm256_or_si256(_mm256_and_si256(even, _mm256_set1_epi16(0x00FF)), _mm256_slli_epi16(odd, 8));
+}
+
+inline __m256i vectorMinMax64(__m256i x, __m256i y, bool isSigned, bool isMax) {
+    __m256i bias = isSigned ? _mm256_setzero_si256() : _mm256_set1_epi64x(static_cast<int64_t>(0x8000000000000000ull));
+    __m256i xGreater = _mm256_cmpgt_epi64(_mm256_xor_si256(x, bias), _mm256_xor_si256(y, bias));
+    return isMax ? _mm256_blendv_epi8(y, x, xGreater) : _mm256_blendv_epi8(x, y, xGreater);
+}
+
+#elif defined(__SSE2__)
+
+inline __m128i vectorMul8(__m128i x, __m128i y) {
+    __m128i even = _mm_mullo_epi16(x, y);
+    __m128i odd  = _mm_mullo_epi16(_mm_srli_epi16(x, 8), _mm_srli_epi16(y, 8));
+    return _mm_or_si128(_mm_and_si128(even, _mm_set1_epi16(0x00FF)), _mm_slli_epi16(odd, 8));
+}
+
+// SSE2 only has unsigned 8 bit and signed 16 bit min/max. Flipping the top bit of each
+// lane turns one into the other.
+inline __m128i vectorFlipMinMax(__m128i x, __m128i y, __m128i bias, bool isMax, bool bytes) {
+    x = _mm_xor_si128(x, bias);
+    y = _mm_xor_si128(y, bias);
+    __m128i r = bytes ? (isMax ? _mm_max_epu8(x, y)  : _mm_min_epu8(x, y))
+                      : (isMax ? _mm_max_epi16(x, y) : _mm_min_epi16(x, y));
+    return _mm_xor_si128(r, bias);
+}
+
+#if defined(__SSE4_2__)
+inline __m128i vectorMinMax64(__m128i x, __m128i y, bool isSigned, bool isMax) {
+    __m128i bias = isSigned ? _mm_setzero_si128() : _mm_set1_epi64x(static_cast<int64_t>(0x8000000000000000ull));
+    __m128i xGreater = _mm_cmpgt_epi64(_mm_xor_si128(x, bias), _mm_xor_si128(y, bias));
+    return isMax ? _mm_blendv_epi8(y, x, xGreater) : _mm_blendv_epi8(x, y, xGreater);
+}
+#endif
+
+// One 128 bit half of a vector register. False when this host has no instruction for
+// the op and lane size, in which case the caller runs the whole register as scalar.
+inline bool vectorHalf(uint8_t op, int laneBytes, __m128i x, __m128i y, __m128i& r) {
+    __m128i sign8  = _mm_set1_epi8(static_cast<char>(0x80));
+    __m128i sign16 = _mm_set1_epi16(static_cast<short>(0x8000));
+
+    switch ((op << 4) | laneBytes) {
+        case (VOP_ADD << 4) | 1:   r = _mm_add_epi8(x, y);   break;
+        case (VOP_ADD << 4) | 2:   r = _mm_add_epi16(x, y);  break;
+        case (VOP_ADD << 4) | 4:   r = _mm_add_epi32(x, y);  break;
+        case (VOP_ADD << 4) | 8:   r = _mm_add_epi64(x, y);  break;
+        case (VOP_SUB << 4) | 1:   r = _mm_sub_epi8(x, y);   break;
+        case (VOP_SUB << 4) | 2:   r = _mm_sub_epi16(x, y);  break;
+        case (VOP_SUB << 4) | 4:   r = _mm_sub_epi32(x, y);  break;
+        case (VOP_SUB << 4) | 8:   r = _mm_sub_epi64(x, y);  break;
+        case (VOP_MUL << 4) | 1:   r = vectorMul8(x, y);     break;
+        case (VOP_MUL << 4) | 2:   r = _mm_mullo_epi16(x, y); break;
+        case (VOP_UMIN << 4) | 1:  r = _mm_min_epu8(x, y);   break;
+        case (VOP_UMIN << 4) | 2:  r = vectorFlipMinMax(x, y, sign16, false, false); break;
+        case (VOP_UMAX << 4) | 1:  r = _mm_max_epu8(x, y);   break;
+        case (VOP_UMAX << 4) | 2:  r = vectorFlipMinMax(x, y, sign16, true, false); break;
+        case (VOP_SMIN << 4) | 1:  r = vectorFlipMinMax(x, y, sign8, false, true); break;
+        case (VOP_SMIN << 4) | 2:  r = _mm_min_epi16(x, y);  break;
+        case (VOP_SMAX << 4) | 1:  r = vectorFlipMinMax(x, y, sign8, true, true); break;
+        case (VOP_SMAX << 4) | 2:  r = _mm_max_epi16(x, y);  break;
+        case (VOP_CMPEQ << 4) | 1: r = _mm_cmpeq_epi8(x, y);  break;
+        case (VOP_CMPEQ << 4) | 2: r = _mm_cmpeq_epi16(x, y); break;
+        case (VOP_CMPEQ << 4) | 4: r = _mm_cmpeq_epi32(x, y); break;
+#if defined(__SSE4_1__)
+        case (VOP_MUL << 4) | 4:   r = _mm_mullo_epi32(x, y); break;
+        case (VOP_UMIN << 4) | 4:  r = _mm_min_epu32(x, y);  break;
+        case (VOP_UMAX << 4) | 4:  r = _mm_max_epu32(x, y);  break;
+        case (VOP_SMIN << 4) | 4:  r = _mm_min_epi32(x, y);  break;
+        case (VOP_SMAX << 4) | 4:  r = _mm_max_epi32(x, y);  break;
+        case (VOP_CMPEQ << 4) | 8: r = _mm_cmpeq_epi64(x, y); break;
+#endif
+#if defined(__SSE4_2__)
+        case (VOP_UMIN << 4) | 8:  r = vectorMinMax64(x, y, false, false); break;
+        case (VOP_UMAX << 4) | 8:  r = vectorMinMax64(x, y, false, true); break;
+        case (VOP_SMIN << 4) | 8:  r = vectorMinMax64(x, y, true, false); break;
+        case (VOP_SMAX << 4) | 8:  r = vectorMinMax64(x, y, true, true); break;
+#endif
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+#endif
+
+inline void vectorArithmetic(uint8_t op, int laneBytes, uint8_t* d, const uint8_t* a, const uint8_t* b) {
+#if defined(__AVX2__)
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    __m256i r;
+
+    switch ((op << 4) | laneBytes) {
+        case (VOP_ADD << 4) | 1:   r = _mm256_add_epi8(x, y);   break;
+        case (VOP_ADD << 4) | 2:   r = _mm256_add_epi16(x, y);  break;
+        case (VOP_ADD << 4) | 4:   r = _mm256_add_epi32(x, y);  break;
+        case (VOP_ADD << 4) | 8:   r = _mm256_add_epi64(x, y);  break;
+        case (VOP_SUB << 4) | 1:   r = _mm256_sub_epi8(x, y);   break;
+        case (VOP_SUB << 4) | 2:   r = _mm256_sub_epi16(x, y);  break;
+        case (VOP_SUB << 4) | 4:   r = _mm256_sub_epi32(x, y);  break;
+        case (VOP_SUB << 4) | 8:   r = _mm256_sub_epi64(x, y);  break;
+        case (VOP_MUL << 4) | 1:   r = vectorMul8(x, y);        break;
+        case (VOP_MUL << 4) | 2:   r = _mm256_mullo_epi16(x, y); break;
+        case (VOP_MUL << 4) | 4:   r = _mm256_mullo_epi32(x, y); break;
+        case (VOP_UMIN << 4) | 1:  r = _mm256_min_epu8(x, y);   break;
+        case (VOP_UMIN << 4) | 2:  r = _mm256_min_epu16(x, y);  break;
+        case (VOP_UMIN << 4) | 4:  r = _mm256_min_epu32(x, y);  break;
+        case (VOP_UMIN << 4) | 8:  r = vectorMinMax64(x, y, false, false); break;
+        case (VOP_UMAX << 4) | 1:  r = _mm256_max_epu8(x, y);   break;
+        case (VOP_UMAX << 4) | 2:  r = _mm256_max_epu16(x, y);  break;
+        case (VOP_UMAX << 4) | 4:  r = _mm256_max_epu32(x, y);  break;
+        case (VOP_UMAX << 4) | 8:  r = vectorMinMax64(x, y, false, true); break;
+        case (VOP_SMIN << 4) | 1:  r = _mm256_min_epi8(x, y);   break;
+        case (VOP_SMIN << 4) | 2:  r = _mm256_min_epi16(x, y);  break;
+        case (VOP_SMIN << 4) | 4:  r = _mm256_min_epi32(x, y);  break;
+        case (VOP_SMIN << 4) | 8:  r = vectorMinMax64(x, y, true, false); break;
+        case (VOP_SMAX << 4) | 1:  r = _mm256_max_epi8(x, y);   break;
+        case (VOP_SMAX << 4) | 2:  r = _mm256_max_epi16(x, y);  break;
+        case (VOP_SMAX << 4) | 4:  r = _mm256_max_epi32(x, y);  break;
+        case (VOP_SMAX << 4) | 8:  r = vectorMinMax64(x, y, true, true); break;
+        case (VOP_CMPEQ << 4) | 1: r = _mm256_cmpeq_epi8(x, y);  break;
+        case (VOP_CMPEQ << 4) | 2: r = _mm256_cmpeq_epi16(x, y); break;
+        case (VOP_CMPEQ << 4) | 4: r = _mm256_cmpeq_epi32(x, y); break;
+        case (VOP_CMPEQ << 4) | 8: r = _mm256_cmpeq_epi64(x, y); break;
+
+        default:
+            vectorLanesScalar(op, laneBytes, d, a, b);
+            return;
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), r);
+#elif defined(__SSE2__)
+    __m128i r[2];
+    for (int half = 0; half < 2; half++) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 16 * half));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 16 * half));
+        if (!vectorHalf(op, laneBytes, x, y, r[half])) {
+            vectorLanesScalar(op, laneBytes, d, a, b);
+            return;
+        }
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d), r[0]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 16), r[1]);
+#else
+    vectorLanesScalar(op, laneBytes, d, a, b);
+#endif
+}
+
+// d[i] = a[index[i] & 31], indexes may cross the 128 bit halves.
+inline void vectorShuffle(uint8_t* d, const uint8_t* a, const uint8_t* index) {
+#if defined(__AVX2__)
+    __m256i src  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    __m256i idx  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index));
+    __m256i low  = _mm256_permute2x128_si256(src, src, 0x00);
+    __m256i high = _mm256_permute2x128_si256(src, src, 0x11);
+    __m256i lane = _mm256_and_si256(idx, _mm256_set1_epi8(0x0F));
+    __m256i fromLow  = _mm256_shuffle_epi8(low, lane);
+    __m256i fromHigh = _mm256_shuffle_epi8(high, lane);
+    __m256i useHigh  = _mm256_slli_epi16(idx, 3);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), _mm256_blendv_epi8(fromLow, fromHigh, useHigh));
+#elif defined(__SSSE3__)
+    __m128i low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 16));
+    __m128i r[2];
+    for (int half = 0; half < 2; half++) {
+        __m128i idx      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(index + 16 * half));
+        __m128i lane     = _mm_and_si128(idx, _mm_set1_epi8(0x0F));
+        __m128i fromLow  = _mm_shuffle_epi8(low, lane);
+        __m128i fromHigh = _mm_shuffle_epi8(high, lane);
+        __m128i useHigh  = _mm_cmpeq_epi8(_mm_and_si128(idx, _mm_set1_epi8(0x10)), _mm_set1_epi8(0x10));
+        r[half] = _mm_or_si128(_mm_and_si128(useHigh, fromHigh), _mm_andnot_si128(useHigh, fromLow));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d), r[0]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 16), r[1]);
+#else
+    uint8_t result[VECTOR_BYTES];
+    for (int i = 0; i < VECTOR_BYTES; i++) result[i] = a[index[i] & 31];
+    std::memcpy(d, result, VECTOR_BYTES);
+#endif
+}